@@ -0,0 +1,237 @@
+// ----------------------------------------------------------------------------
+// 'BenchmarkFillModes.cxx
+// Derek Anderson
+// 10.18.2026
+//
+// Use to compare the fill throughput of
+// the different histogram fill modes of
+// 'SDeltaPtCutStudy' on toy tracks:
+//   (1) direct TH1D/TH2D::Fill per cut,
+//   (2) contiguous engine, per track (the
+//       default in the track loops),
+//   (3) contiguous engine, buffered (with
+//       'SetFillBufferParameters(true, ...)',
+//       & in deferred fills from track store),
+//   (4) buffered & split over threads.
+// ----------------------------------------------------------------------------
+
+// standard c libraries
+#include <cmath>
+#include <array>
+#include <vector>
+#include <utility>
+#include <iostream>
+// ROOT libraries
+#include <TH1.h>
+#include <TH2.h>
+#include <TError.h>
+#include <TRandom3.h>
+#include <TStopwatch.h>
+// user includes
+#include "../src/SVariantHist.h"
+
+// make common namespaces implicit
+using namespace std;
+
+// global constants
+static const size_t NCol  = 4;
+static const size_t NHist = 8;
+
+
+
+// benchmark histogram fill modes ---------------------------------------------
+
+void BenchmarkFillModes() {
+
+  // lower verbosity
+  gErrorIgnoreLevel = kError;
+  cout << "\n  Beginning fill mode benchmark..." << endl;
+
+  // options ------------------------------------------------------------------
+
+  // no. of toy tracks and cut variants
+  //   (binning & no. of cuts match 'DoDeltaPtCutStudy.C',
+  //   so expect ~2 GB of memory for the direct histograms)
+  const uint64_t nTrks = 2000000;
+  const size_t   nCuts = 7;
+
+  // buffer sizes & no. of threads to try
+  const vector<size_t> vecBufferSizes = {64, 256, 1024, 4096};
+  const vector<size_t> vecThreads     = {2, 4};
+  const size_t         nThreadBuffer  = 16384;
+
+  // flat delta-pt cuts
+  const array<double, nCuts> arrDeltaMax = {0.50, 0.25, 0.10, 0.05, 0.03, 0.02, 0.01};
+
+  // binning (defaults of 'SDeltaPtCutStudy::SetHistBinning()')
+  const SVariantAxis axPt(1000, 0., 100.);
+  const SVariantAxis axFrac(1000, 0., 10.);
+  const SVariantAxis axDelta(5000, 0., 5.);
+
+  // columns & (x, y) columns of each histogram
+  enum Col {CDelta, CTrack, CFrac, CTrkTru};
+  const vector<SVariantAxis>   vecColAxes = {axDelta, axPt, axFrac, axPt};
+  const vector<pair<int, int>> vecHistCols = {
+    make_pair(CDelta,  -1),
+    make_pair(CTrack,  -1),
+    make_pair(CFrac,   -1),
+    make_pair(CTrkTru, -1),
+    make_pair(CFrac,   CDelta),
+    make_pair(CTrkTru, CDelta),
+    make_pair(CTrack,  CDelta),
+    make_pair(CTrack,  CTrkTru)
+  };
+
+  // generate toy tracks ------------------------------------------------------
+
+  TRandom3 random(1);
+  vector<array<double, NCol>> vecTrks(nTrks);
+  for (auto& trk : vecTrks) {
+    const double gpt   = random.Uniform(0.2, 40.);
+    const double delta = abs(random.Gaus(0.01, 0.02));
+    const double pt    = gpt * random.Gaus(1., delta);
+    trk = {delta, pt, pt / gpt, gpt};
+  }
+  cout << "    Generated " << nTrks << " toy tracks." << endl;
+
+  // for throughput
+  auto report = [&](const TString label, TStopwatch& watch) {
+    const double time = watch.RealTime();
+    cout << "      " << label << ": " << time << " s, " << (nTrks / time) / 1e6 << " M tracks/s" << endl;
+  };  // end 'report(TString, TStopwatch&)'
+
+  // (1) direct fills ---------------------------------------------------------
+
+  vector<TH1*> vecDirect;
+  for (size_t iCut = 0; iCut <= nCuts; iCut++) {
+    TString suffix("_");
+    suffix += iCut;
+    vecDirect.push_back(new TH1D("hDelta"        + suffix, "", axDelta.nBins, axDelta.xMin, axDelta.xMax));
+    vecDirect.push_back(new TH1D("hTrack"        + suffix, "", axPt.nBins,    axPt.xMin,    axPt.xMax));
+    vecDirect.push_back(new TH1D("hFrac"         + suffix, "", axFrac.nBins,  axFrac.xMin,  axFrac.xMax));
+    vecDirect.push_back(new TH1D("hTrkTru"       + suffix, "", axPt.nBins,    axPt.xMin,    axPt.xMax));
+    vecDirect.push_back(new TH2D("hDeltaVsFrac"  + suffix, "", axFrac.nBins,  axFrac.xMin,  axFrac.xMax, axDelta.nBins, axDelta.xMin, axDelta.xMax));
+    vecDirect.push_back(new TH2D("hDeltaVsTrue"  + suffix, "", axPt.nBins,    axPt.xMin,    axPt.xMax,   axDelta.nBins, axDelta.xMin, axDelta.xMax));
+    vecDirect.push_back(new TH2D("hDeltaVsTrack" + suffix, "", axPt.nBins,    axPt.xMin,    axPt.xMax,   axDelta.nBins, axDelta.xMin, axDelta.xMax));
+    vecDirect.push_back(new TH2D("hTrueVsTrack"  + suffix, "", axPt.nBins,    axPt.xMin,    axPt.xMax,   axPt.nBins,    axPt.xMin,    axPt.xMax));
+  }
+  for (TH1* hist : vecDirect) {
+    hist -> Sumw2();
+  }
+
+  TStopwatch watch;
+  watch.Start();
+  for (const auto& trk : vecTrks) {
+    for (size_t iCut = 0; iCut <= nCuts; iCut++) {
+      if ((iCut < nCuts) && !(trk[CDelta] < arrDeltaMax[iCut])) continue;
+      TH1** hists = &vecDirect[iCut * NHist];
+      hists[0] -> Fill(trk[CDelta]);
+      hists[1] -> Fill(trk[CTrack]);
+      hists[2] -> Fill(trk[CFrac]);
+      hists[3] -> Fill(trk[CTrkTru]);
+      hists[4] -> Fill(trk[CFrac],   trk[CDelta]);
+      hists[5] -> Fill(trk[CTrkTru], trk[CDelta]);
+      hists[6] -> Fill(trk[CTrack],  trk[CDelta]);
+      hists[7] -> Fill(trk[CTrack],  trk[CTrkTru]);
+    }
+  }
+  watch.Stop();
+  cout << "    Results:" << endl;
+  report("direct TH1::Fill", watch);
+
+  // free direct histograms before allocating engines
+  for (TH1* hist : vecDirect) {
+    delete hist;
+  }
+  vecDirect.clear();
+
+  // (2) engine, per track ----------------------------------------------------
+
+  auto makeEngines = [&]() {
+    vector<SVariantHist> engines(NHist);
+    for (size_t iHist = 0; iHist < NHist; iHist++) {
+      const SVariantAxis& axX = vecColAxes[vecHistCols[iHist].first];
+      if (vecHistCols[iHist].second < 0) {
+        engines[iHist] = SVariantHist(nCuts + 1, axX);
+      } else {
+        engines[iHist] = SVariantHist(nCuts + 1, axX, vecColAxes[vecHistCols[iHist].second]);
+      }
+    }
+    return engines;
+  };  // end 'makeEngines()'
+
+  vector<SVariantHist> vecEngines = makeEngines();
+  watch.Start();
+  for (const auto& trk : vecTrks) {
+    array<uint32_t, NCol> bins;
+    for (size_t iCol = 0; iCol < NCol; iCol++) {
+      bins[iCol] = vecColAxes[iCol].FindBin(trk[iCol]);
+    }
+    for (size_t iHist = 0; iHist < NHist; iHist++) {
+      const int      iColY = vecHistCols[iHist].second;
+      const uint64_t iBin  = vecEngines[iHist].GetBin(bins[vecHistCols[iHist].first], (iColY < 0) ? 0 : bins[iColY]);
+      for (size_t iCut = 0; iCut <= nCuts; iCut++) {
+        if ((iCut < nCuts) && !(trk[CDelta] < arrDeltaMax[iCut])) continue;
+        vecEngines[iHist].Fill(iCut, iBin);
+      }
+    }
+  }
+  watch.Stop();
+  report("engine, per track", watch);
+
+  // (3) engine, buffered -----------------------------------------------------
+
+  for (const size_t size : vecBufferSizes) {
+    vecEngines = makeEngines();
+
+    SFillBuffer buffer(vecColAxes, size);
+    watch.Start();
+    for (const auto& trk : vecTrks) {
+      uint64_t pass = (1ULL << nCuts);
+      for (size_t iCut = 0; iCut < nCuts; iCut++) {
+        if (trk[CDelta] < arrDeltaMax[iCut]) pass |= (1ULL << iCut);
+      }
+      buffer.Add(trk.data(), pass);
+      if (buffer.IsFull()) buffer.Flush(vecEngines, vecHistCols);
+    }
+    buffer.Flush(vecEngines, vecHistCols);
+    watch.Stop();
+
+    TString label("engine, buffered (size = ");
+    label += size;
+    label += ")";
+    report(label, watch);
+  }
+
+  // (4) engine, buffered & threaded -----------------------------------------
+
+  for (const size_t nThreads : vecThreads) {
+    vecEngines = makeEngines();
+
+    // threads are started once, & each owns whole engines
+    const SFitPool pool(nThreads);
+    SFillBuffer    buffer(vecColAxes, nThreadBuffer);
+    watch.Start();
+    for (const auto& trk : vecTrks) {
+      uint64_t pass = (1ULL << nCuts);
+      for (size_t iCut = 0; iCut < nCuts; iCut++) {
+        if (trk[CDelta] < arrDeltaMax[iCut]) pass |= (1ULL << iCut);
+      }
+      buffer.Add(trk.data(), pass);
+      if (buffer.IsFull()) buffer.Flush(vecEngines, vecHistCols, pool);
+    }
+    buffer.Flush(vecEngines, vecHistCols, pool);
+    watch.Stop();
+
+    TString label("engine, buffered (size = ");
+    label += nThreadBuffer;
+    label += ", threads = ";
+    label += nThreads;
+    label += ")";
+    report(label, watch);
+  }
+  cout << "  Finished fill mode benchmark!\n" << endl;
+
+}
+
+// end ------------------------------------------------------------------------
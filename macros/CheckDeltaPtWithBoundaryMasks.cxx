@@ -13,16 +13,24 @@
 #include <vector>
 #include <utility>
 #include <iostream>
+#include <algorithm>
 // ROOT libraries
 #include <TH1.h>
 #include <TH2.h>
 #include <TF1.h>
 #include <TFile.h>
 #include <TError.h>
+#include <TGraph.h>
 #include <TNtuple.h>
+#include <TVectorD.h>
 #include <TDirectory.h>
 #include <ROOT/RDataFrame.hxx>
 #include <ROOT/RDF/HistoModels.hxx>
+// user includes
+#include "../src/SPrefixSum.h"
+#include "../src/SSectorMask.h"
+#include "../src/SSectorFinder.h"
+#include "../src/SGaussEstimate.h"
 
 // make common namespaces implicit
 using namespace std;
@@ -63,29 +71,20 @@ void CheckDeltaPtWithBoundaryMasks() {
   // mask parameters
   const double maskSize = 0.02;
 
-  // fit guesses
-  const array<float, NSectors> arrMeanGuess = {
-    -2.877,
-    -2.354,
-    -1.831,
-    -1.308,
-    -0.785,
-    -0.262,
-    0.262,
-    0.785,
-    1.308,
-    1.831,
-    2.354,
-    2.877
-  };
-  const float sigmaGuess = maskSize;
-  const float ampGuess   = 10.;
-  const float fitRange   = 2. * maskSize;
+  // boundary finder parameters (0 threads = one per core)
+  const float  fitRange    = 2. * maskSize;
+  const size_t nSmooth     = 3;
+  const size_t nFitThreads = 0;
+
+  // mask width scan parameters: range of delta-pt/pt the
+  // resolution estimate starts from, & widths to announce
+  const pair<double, double> resRange     = {0., 0.1};
+  const vector<double>       vecWidthShow = {0.01, 0.02, 0.04, 0.08};
 
   // histogram definitions ----------------------------------------------------
 
   // binning accessor
-  enum Var {VEne, VPhi, VDPt, VFrac};
+  enum Var {VEne, VPhi, VDPt, VFrac, VDist};
 
   // other variable binning
   //   <0> = no. of bins
@@ -95,7 +94,8 @@ void CheckDeltaPtWithBoundaryMasks() {
     make_tuple(200,    0.,   100.),
     make_tuple(360,   -3.15, 3.15),
     make_tuple(5000,   0.,   5.),
-    make_tuple(5000,   0.,   5.)
+    make_tuple(5000,   0.,   5.),
+    make_tuple(262,    0.,   0.262)
   };
 
   // histogram accessors
@@ -161,8 +161,8 @@ void CheckDeltaPtWithBoundaryMasks() {
   // for storing vectors
   vector<pair<Leaves, TH1Mod>>         vecArgAndHistRow1D;
   vector<pair<Leaves, TH2Mod>>         vecArgAndHistRow2D;
-  vector<vector<pair<Leaves, TH1Mod>>> vecArgAndHist1D(nCuts);
-  vector<vector<pair<Leaves, TH2Mod>>> vecArgAndHist2D(nCuts);
+  vector<vector<pair<Leaves, TH1Mod>>> vecArgAndHist1D;
+  vector<vector<pair<Leaves, TH2Mod>>> vecArgAndHist2D;
 
   // instantiate histograms & load into vectors
   for (const string cut : vecCutLabels) {
@@ -229,17 +229,20 @@ void CheckDeltaPtWithBoundaryMasks() {
     return a / b;
   };  // end 'getFrac(float, float)'
 
-  auto isInMask = [](const float phi, const double mask, const auto& sectors) {
-    bool inMask = false;
-    for (const float sector : sectors) {
-      if ((phi > (sector - (mask / 2.))) && (phi < (sector + (mask / 2.)))) {
-        inMask = true;
-        break;
-      }
-    }
-    return inMask;
+  // mask is set once boundaries are found
+  SSectorMask mask;
+  auto isInMask = [&mask](const float phi) {
+    return mask.IsMasked(phi);
   };  // end 'isInMask(float)'
 
+  auto isOutOfMask = [&mask](const float phi) {
+    return !mask.IsMasked(phi);
+  };  // end 'isOutOfMask(float)'
+
+  auto getDist = [&mask](const float phi) {
+    return mask.GetDistance(phi);
+  };  // end 'getDist(float)'
+
   // run analyses -------------------------------------------------------------
 
   // get histograms before masking
@@ -270,14 +273,102 @@ void CheckDeltaPtWithBoundaryMasks() {
     vecOutHist2D[Cut::Before].push_back(hist2D);
   }
 
-  /* TODO
-   *   - get sector bourndaries with fits
-   */
+  // find sector boundaries: peaks in delta-pt/pt vs. phi,
+  // refined by fits run concurrently
+  const SFitPool pool(nFitThreads);
+  if (pool.GetNThreads() > 1) SFitPool::EnableThreadSafeFits();
+
+  SSectorFinder finder(NSectors);
+  finder.SetSmoothing(nSmooth);
+
+  const vector<double> vecSectors = finder.Find(vecOutHist2D[Cut::Before][0], pool, fitRange);
+  finder.PrintTable();
+  cout << "    Found sector boundaries." << endl;
 
   // for masking sector boundaries
-  array<float, NSectors> arrSectors;
-  arrSectors.fill(0.);
-  
+  mask.Init(vecSectors, maskSize);
+
+  // get histograms after masking (filters have distinct
+  // types, so both are held as generic nodes)
+  ROOT::RDF::RNode left = before.Filter(isOutOfMask, {"phi"});
+  ROOT::RDF::RNode cut  = before.Filter(isInMask,    {"phi"});
+  for (const size_t iCut : {Cut::Left, Cut::Cut}) {
+    ROOT::RDF::RNode masked = (iCut == Cut::Left) ? left : cut;
+    for (const auto argAndHist1D : vecArgAndHist1D[iCut]) {
+      auto hist1D = masked.Histo1D(argAndHist1D.second, argAndHist1D.first.first.data());
+      vecHistResult1D[iCut].push_back(hist1D);
+    }
+    for (const auto argAndHist2D : vecArgAndHist2D[iCut]) {
+      auto hist2D = masked.Histo2D(argAndHist2D.second, argAndHist2D.first.first.data(), argAndHist2D.first.second.data());
+      vecHistResult2D[iCut].push_back(hist2D);
+    }
+  }
+
+  // in the same pass, bin each track's distance to the nearest boundary
+  // against delta-pt/pt, so masks of any width can be read out later
+  const THBins distBins = vecBins[Var::VDist];
+  const THBins dPtBins  = vecBins[Var::VDPt];
+  const TH2Mod distMod  = TH2Mod("hDPtVsDist", ";#Delta#varphi^{trk} to nearest boundary;#deltap_{T}^{reco}/p_{T}^{reco}", get<0>(distBins), get<1>(distBins), get<2>(distBins), get<0>(dPtBins), get<1>(dPtBins), get<2>(dPtBins));
+  auto distResult = before.Define("phiDist", getDist, {"phi"}).Histo2D(distMod, "phiDist", "ptErr");
+
+  // retrieve results
+  for (const size_t iCut : {Cut::Left, Cut::Cut}) {
+    for (auto histResult1D : vecHistResult1D[iCut]) {
+      vecOutHist1D[iCut].push_back((TH1D*) histResult1D -> Clone());
+    }
+    for (auto histResult2D : vecHistResult2D[iCut]) {
+      vecOutHist2D[iCut].push_back((TH2D*) histResult2D -> Clone());
+    }
+  }
+  cout << "    Masked sector boundaries." << endl;
+
+  // scan mask widths: a mask of width w keeps the tracks at distance
+  // >= w/2, so its delta-pt/pt distribution & no. of tracks kept are
+  // both cumulative integrals over distance
+  TH2D*          hDPtVsDist = (TH2D*) distResult -> Clone();
+  const uint32_t nDistBins  = get<0>(distBins);
+  const uint32_t nDPtBins   = get<0>(dPtBins);
+
+  SPrefixSum2D psDist;
+  psDist.Build(hDPtVsDist -> GetArray(), nDistBins, nDPtBins);
+
+  const double nAllTrks = psDist.Integral(0, nDistBins + 1, 0, nDPtBins + 1);
+
+  const SVariantAxis axDPt(nDPtBins, get<1>(dPtBins), get<2>(dPtBins));
+  vector<double>     slice(nDPtBins);
+  vector<double>     vecWidth;
+  vector<double>     vecKept;
+  vector<double>     vecSigma;
+  for (uint32_t iDist = 1; iDist <= nDistBins; iDist++) {
+    psDist.GetSliceY(iDist, nDistBins + 1, slice.data());
+
+    const double         nKept    = psDist.Integral(iDist, nDistBins + 1, 0, nDPtBins + 1);
+    const SGaussEstimate estimate = EstimateGauss(slice.data(), 1, axDPt, resRange.first, resRange.second);
+    if ((nKept <= 0.) || !estimate.isGood) continue;
+
+    vecWidth.push_back(2. * hDPtVsDist -> GetXaxis() -> GetBinLowEdge(iDist));
+    vecKept.push_back(nKept / nAllTrks);
+    vecSigma.push_back(estimate.sigma);
+  }
+
+  // resolution & acceptance vs. width, & resolution vs. acceptance
+  TGraph* grSigmaVsWidth = new TGraph(vecWidth.size(), vecWidth.data(), vecSigma.data());
+  TGraph* grKeptVsWidth  = new TGraph(vecWidth.size(), vecWidth.data(), vecKept.data());
+  TGraph* grSigmaVsKept  = new TGraph(vecWidth.size(), vecKept.data(),  vecSigma.data());
+  grSigmaVsWidth -> SetName("grSigmaVsMaskWidth");
+  grKeptVsWidth  -> SetName("grKeptVsMaskWidth");
+  grSigmaVsKept  -> SetName("grSigmaVsKeptFraction");
+
+  // announce a few widths
+  cout << "    Scanned " << vecWidth.size() << " mask widths:" << endl;
+  for (const double widthShow : vecWidthShow) {
+    const auto iWidth = lower_bound(vecWidth.begin(), vecWidth.end(), widthShow);
+    if (iWidth == vecWidth.end()) continue;
+
+    const size_t iPoint = iWidth - vecWidth.begin();
+    cout << "      width = " << vecWidth[iPoint] << ": kept fraction = " << vecKept[iPoint] << ", sigma(delta-pt/pt) = " << vecSigma[iPoint] << endl;
+  }
+
   // save & close -------------------------------------------------------------
 
   // save histograms
@@ -294,6 +385,26 @@ void CheckDeltaPtWithBoundaryMasks() {
   }
   cout << "    Saved histograms." << endl;
 
+  // save boundary table & fits
+  TVectorD tvecSectors(vecSectors.size(), vecSectors.data());
+  TDirectory* dFinder = (TDirectory*) fOutput -> mkdir("SectorFinder");
+  dFinder -> cd();
+  tvecSectors.Write("vecSectorBoundaries");
+  finder.GetProfile() -> Write();
+  for (TH1D* window : finder.GetWindows()) {
+    window -> Write();
+  }
+  cout << "    Saved sector boundaries." << endl;
+
+  // save mask width scan
+  TDirectory* dScan = (TDirectory*) fOutput -> mkdir("MaskWidthScan");
+  dScan          -> cd();
+  hDPtVsDist     -> Write();
+  grSigmaVsWidth -> Write();
+  grKeptVsWidth  -> Write();
+  grSigmaVsKept  -> Write();
+  cout << "    Saved mask width scan." << endl;
+
   // close files
   fOutput -> cd();
   fOutput -> Close();
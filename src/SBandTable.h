@@ -0,0 +1,153 @@
+// ----------------------------------------------------------------------------
+// 'SBandTable.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Lookup-table representation of a pt-
+// dependent cut band. A monotone cubic
+// (Fritsch-Carlson) is put through the
+// band points and tabulated on a fixed
+// pt axis, so evaluating the band is a
+// single array index, and the band stays
+// flat (instead of running away like a
+// global polynomial) outside the points.
+// ----------------------------------------------------------------------------
+
+#ifndef SBANDTABLE_H
+#define SBANDTABLE_H
+
+// standard c includes
+#include <cmath>
+#include <vector>
+#include <cstdint>
+// user includes
+#include "SVariantHist.h"
+
+using namespace std;
+
+
+
+// SBandTable definition ------------------------------------------------------
+
+struct SBandTable {
+
+  // table axis & values per bin (under/overflow hold the end values)
+  SVariantAxis  axis;
+  vector<float> values;
+
+  // tabulate a monotone interpolation of (x, y) on tableAxis,
+  // where x must be increasing
+  void Build(const vector<double>& x, const vector<double>& y, const SVariantAxis& tableAxis);
+
+  // band value at x
+  inline float Eval(const double x) const {return values[axis.FindBin(x)];}
+
+};  // end SBandTable definition
+
+
+
+// SBandTable implementation --------------------------------------------------
+
+inline void SBandTable::Build(const vector<double>& x, const vector<double>& y, const SVariantAxis& tableAxis) {
+
+  axis = tableAxis;
+  values.assign(axis.nBins + 2, 0.);
+
+  // trivial cases
+  const size_t nPoints = x.size();
+  if (nPoints == 0) return;
+  if (nPoints == 1) {
+    values.assign(axis.nBins + 2, y[0]);
+    return;
+  }
+
+  // secant slopes
+  vector<double> width(nPoints - 1);
+  vector<double> secant(nPoints - 1);
+  for (size_t iPoint = 0; iPoint < (nPoints - 1); iPoint++) {
+    width[iPoint]  = x[iPoint + 1] - x[iPoint];
+    secant[iPoint] = (y[iPoint + 1] - y[iPoint]) / width[iPoint];
+  }
+
+  // tangents: zero at local extrema, weighted harmonic mean
+  // of the neighbouring secants otherwise (no overshoot)
+  vector<double> tangent(nPoints);
+  tangent[0]           = secant[0];
+  tangent[nPoints - 1] = secant[nPoints - 2];
+  for (size_t iPoint = 1; iPoint < (nPoints - 1); iPoint++) {
+    const double lo = secant[iPoint - 1];
+    const double hi = secant[iPoint];
+    if ((lo * hi) <= 0.) {
+      tangent[iPoint] = 0.;
+    } else {
+      const double w1 = (2. * width[iPoint]) + width[iPoint - 1];
+      const double w2 = width[iPoint] + (2. * width[iPoint - 1]);
+      tangent[iPoint] = (w1 + w2) / ((w1 / lo) + (w2 / hi));
+    }
+  }
+
+  // tabulate at bin centers, clamping outside points
+  const double binWidth = (axis.xMax - axis.xMin) / axis.nBins;
+  size_t       iSeg     = 0;
+  for (uint32_t iBin = 1; iBin <= axis.nBins; iBin++) {
+    const double center = axis.xMin + ((iBin - 0.5) * binWidth);
+    if (center <= x[0]) {
+      values[iBin] = y[0];
+      continue;
+    }
+    if (center >= x[nPoints - 1]) {
+      values[iBin] = y[nPoints - 1];
+      continue;
+    }
+    while (center > x[iSeg + 1]) ++iSeg;
+
+    // cubic hermite on segment
+    const double s   = (center - x[iSeg]) / width[iSeg];
+    const double s2  = s * s;
+    const double s3  = s2 * s;
+    const double h00 = (2. * s3) - (3. * s2) + 1.;
+    const double h10 = s3 - (2. * s2) + s;
+    const double h01 = (3. * s2) - (2. * s3);
+    const double h11 = s3 - s2;
+    values[iBin] = (h00 * y[iSeg]) + (h10 * width[iSeg] * tangent[iSeg]) + (h01 * y[iSeg + 1]) + (h11 * width[iSeg] * tangent[iSeg + 1]);
+  }
+
+  // under/overflow hold end values
+  values[0]              = values[1];
+  values[axis.nBins + 1] = values[axis.nBins];
+  return;
+
+}  // end 'Build(vector<double>&, vector<double>&, SVariantAxis&)'
+
+
+
+// slice quantiles ------------------------------------------------------------
+
+// value below which a fraction frac of the (in-range) contents of
+// a slice lies, interpolating linearly within the crossing bin;
+// contents[iBin] is the content of bin iBin + 1 of axis
+inline double GetSliceQuantile(const double* contents, const SVariantAxis& axis, const double frac) {
+
+  double sum = 0.;
+  for (uint32_t iBin = 0; iBin < axis.nBins; iBin++) {
+    sum += contents[iBin];
+  }
+  if (sum <= 0.) return 0.;
+
+  const double target   = frac * sum;
+  const double binWidth = (axis.xMax - axis.xMin) / axis.nBins;
+  double       below    = 0.;
+  for (uint32_t iBin = 0; iBin < axis.nBins; iBin++) {
+    const double above = below + contents[iBin];
+    if ((above >= target) && (contents[iBin] > 0.)) {
+      return axis.xMin + ((iBin + ((target - below) / contents[iBin])) * binWidth);
+    }
+    below = above;
+  }
+  return axis.xMax;
+
+}  // end 'GetSliceQuantile(double*, SVariantAxis&, double)'
+
+#endif
+
+// end ------------------------------------------------------------------------
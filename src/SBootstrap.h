@@ -0,0 +1,223 @@
+// ----------------------------------------------------------------------------
+// 'SBootstrap.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Single-pass poisson bootstrap of a set of
+// counters. Each resampling unit (e.g. an
+// event) gets a poisson(1) weight in every
+// replica, hashed from the unit & a seed so
+// the same unit gets the same weights in
+// every loop. Counts of all replicas are
+// accumulated together, in fixed blocks of
+// 32-bit partial sums so the adds vectorize,
+// and are flushed into 64-bit totals before
+// the partial sums can overflow.
+// ----------------------------------------------------------------------------
+
+#ifndef SBOOTSTRAP_H
+#define SBOOTSTRAP_H
+
+// standard c includes
+#include <vector>
+#include <cstdint>
+#include <utility>
+#include <algorithm>
+
+using namespace std;
+
+
+
+// SBootstrap definition ------------------------------------------------------
+
+class SBootstrap {
+
+  public:
+
+    // replicas are handled in blocks of this many, and
+    // partial sums are flushed after this many adds
+    // (weights are at most 8, so they can't overflow)
+    static constexpr size_t NBlock = 16;
+    static constexpr size_t NFlush = 1 << 24;
+
+    // ctor
+    SBootstrap() {}
+
+    // set no. of replicas, no. of counters, & seed, and clear counts
+    void Init(const size_t nReplicas, const size_t nCounters, const uint64_t seed);
+
+    // draw the weight of each replica for a resampling
+    // unit (consecutive calls with one unit draw once)
+    void SetUnit(const uint64_t unit);
+
+    // add current weights to a counter
+    inline void Add(const size_t iCounter);
+
+    // move partial sums into totals
+    void Flush();
+
+    // getters
+    size_t   GetNReplicas() const {return nRep;}
+    size_t   GetNCounters() const {return nCount;}
+    uint64_t GetCount(const size_t iCounter, const size_t iRep) const;
+
+    // raw counts (for checkpoints)
+    const vector<uint64_t>& GetCounts() {Flush(); return counts;}
+    void                    SetCount(const size_t iCell, const uint64_t count) {counts[iCell] = count;}
+
+    // central interval holding a fraction level of values
+    static pair<double, double> GetInterval(vector<double> values, const double level);
+
+  private:
+
+    // 64-bit hash (splitmix64 finalizer)
+    static uint64_t Hash(uint64_t x);
+
+    // add a block-padded row of weights to a row of counts
+    static void AddRow(uint32_t* __restrict__ count, const uint32_t* __restrict__ weight, const size_t nCells);
+
+    // sizes (replicas are padded to a whole no. of blocks)
+    size_t   nRep     = 0;
+    size_t   nPad     = 0;
+    size_t   nCount   = 0;
+    uint64_t seedBoot = 0;
+
+    // current unit & its weights
+    uint64_t         lastUnit = 0;
+    bool             hasUnit  = false;
+    vector<uint32_t> weights;
+
+    // partial sums & totals of each counter/replica
+    size_t           nAdds = 0;
+    vector<uint32_t> partial;
+    vector<uint64_t> counts;
+
+};  // end SBootstrap definition
+
+
+
+// SBootstrap implementation --------------------------------------------------
+
+inline uint64_t SBootstrap::Hash(uint64_t x) {
+
+  x += 0x9e3779b97f4a7c15ULL;
+  x  = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  x  = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+  return x ^ (x >> 31);
+
+}  // end 'Hash(uint64_t)'
+
+
+
+inline void SBootstrap::Init(const size_t nReplicas, const size_t nCounters, const uint64_t seed) {
+
+  nRep     = nReplicas;
+  nPad     = ((nRep + NBlock - 1) / NBlock) * NBlock;
+  nCount   = nCounters;
+  seedBoot = seed;
+  hasUnit  = false;
+  nAdds    = 0;
+  weights.assign(nPad, 0);
+  partial.assign(nCount * nPad, 0);
+  counts.assign(nCount * nPad, 0);
+  return;
+
+}  // end 'Init(size_t, size_t, uint64_t)'
+
+
+
+inline void SBootstrap::SetUnit(const uint64_t unit) {
+
+  if (hasUnit && (unit == lastUnit)) return;
+  lastUnit = unit;
+  hasUnit  = true;
+
+  // poisson(1) cdf in units of 2^-16: a weight is the
+  // no. of thresholds a 16-bit uniform is at or above
+  static const uint32_t thresholds[] = {24109, 48218, 60274, 64292, 65296, 65497, 65530, 65535};
+
+  // each hash gives the uniforms of 4 replicas
+  const uint64_t key = Hash(seedBoot ^ Hash(unit));
+  for (size_t iRep = 0; iRep < nRep; iRep += 4) {
+    const uint64_t bits = Hash(key + iRep);
+    for (size_t iLane = 0; (iLane < 4) && ((iRep + iLane) < nRep); iLane++) {
+      const uint32_t uniform = (bits >> (16 * iLane)) & 0xffff;
+
+      uint32_t weight = 0;
+      for (const uint32_t threshold : thresholds) {
+        weight += (uniform >= threshold);
+      }
+      weights[iRep + iLane] = weight;
+    }
+  }
+  return;
+
+}  // end 'SetUnit(uint64_t)'
+
+
+
+inline void SBootstrap::AddRow(uint32_t* __restrict__ count, const uint32_t* __restrict__ weight, const size_t nCells) {
+
+  for (size_t iStart = 0; iStart < nCells; iStart += NBlock) {
+    for (size_t iLane = 0; iLane < NBlock; iLane++) {
+      count[iStart + iLane] += weight[iStart + iLane];
+    }
+  }
+  return;
+
+}  // end 'AddRow(uint32_t*, uint32_t*, size_t)'
+
+
+
+inline void SBootstrap::Add(const size_t iCounter) {
+
+  AddRow(&partial[iCounter * nPad], weights.data(), nPad);
+  if (++nAdds == NFlush) Flush();
+  return;
+
+}  // end 'Add(size_t)'
+
+
+
+inline void SBootstrap::Flush() {
+
+  for (size_t iCell = 0; iCell < counts.size(); iCell++) {
+    counts[iCell] += partial[iCell];
+    partial[iCell] = 0;
+  }
+  nAdds = 0;
+  return;
+
+}  // end 'Flush()'
+
+
+
+inline uint64_t SBootstrap::GetCount(const size_t iCounter, const size_t iRep) const {
+
+  const size_t iCell = (iCounter * nPad) + iRep;
+  return counts[iCell] + partial[iCell];
+
+}  // end 'GetCount(size_t, size_t)'
+
+
+
+inline pair<double, double> SBootstrap::GetInterval(vector<double> values, const double level) {
+
+  if (values.empty()) return make_pair(0., 0.);
+  sort(values.begin(), values.end());
+
+  // linear interpolation between order statistics
+  auto quantile = [&](const double prob) {
+    const double pos  = prob * (values.size() - 1);
+    const size_t iLo  = (size_t) pos;
+    const size_t iHi  = min(iLo + 1, values.size() - 1);
+    const double frac = pos - iLo;
+    return ((1. - frac) * values[iLo]) + (frac * values[iHi]);
+  };  // end 'quantile(double)'
+  return make_pair(quantile(0.5 * (1. - level)), quantile(0.5 * (1. + level)));
+
+}  // end 'GetInterval(vector<double>, double)'
+
+#endif
+
+// end ------------------------------------------------------------------------
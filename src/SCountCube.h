@@ -0,0 +1,183 @@
+// ----------------------------------------------------------------------------
+// 'SCountCube.h'
+// Derek Anderson
+// 10.18.2026
+//
+// N-dimensional histogram of counts with
+// an N-d prefix-sum index, so the count in
+// any box of bins (i.e. any combination of
+// one-sided or two-sided cuts on binned
+// variables) is a 2^N term lookup instead
+// of a rescan. Also has the Pareto front
+// of a set of (efficiency, rejection)
+// points.
+// ----------------------------------------------------------------------------
+
+#ifndef SCOUNTCUBE_H
+#define SCOUNTCUBE_H
+
+// standard c includes
+#include <vector>
+#include <cstdint>
+#include <numeric>
+#include <algorithm>
+// user includes
+#include "SVariantHist.h"
+
+using namespace std;
+
+
+
+// SCountCube definition ------------------------------------------------------
+
+class SCountCube {
+
+  public:
+
+    // ctor
+    SCountCube() {}
+
+    // set axes (bins are numbered as in TH1: 0 = underflow,
+    // nBins + 1 = overflow) & clear counts
+    void Init(const vector<SVariantAxis>& cubeAxes);
+
+    // add a count at values[0...N-1]
+    void Fill(const double* values, const double weight = 1.);
+
+    // turn counts into cumulative sums, after
+    // which only Integral() should be used
+    void BuildIndex();
+
+    // sum of bins in box [lo[d], hi[d]] along each dimension d
+    double Integral(const uint32_t* lo, const uint32_t* hi) const;
+
+    // getters
+    size_t              GetNDims()                 const {return axes.size();}
+    size_t              GetNCells()                const {return sums.size();}
+    bool                IsIndexed()                const {return isIndexed;}
+    const SVariantAxis& GetAxis(const size_t iDim) const {return axes[iDim];}
+
+  private:
+
+    // axes, strides, & cell contents (or cumulative sums)
+    vector<SVariantAxis> axes;
+    vector<size_t>       stride;
+    vector<double>       sums;
+    bool                 isIndexed = false;
+
+};  // end SCountCube definition
+
+
+
+// SCountCube implementation --------------------------------------------------
+
+inline void SCountCube::Init(const vector<SVariantAxis>& cubeAxes) {
+
+  // first dimension runs fastest
+  axes = cubeAxes;
+  stride.resize(axes.size());
+
+  size_t nCells = 1;
+  for (size_t iDim = 0; iDim < axes.size(); iDim++) {
+    stride[iDim] = nCells;
+    nCells      *= axes[iDim].nBins + 2;
+  }
+  sums.assign(nCells, 0.);
+  isIndexed = false;
+  return;
+
+}  // end 'Init(vector<SVariantAxis>&)'
+
+
+
+inline void SCountCube::Fill(const double* values, const double weight) {
+
+  size_t iCell = 0;
+  for (size_t iDim = 0; iDim < axes.size(); iDim++) {
+    iCell += axes[iDim].FindBin(values[iDim]) * stride[iDim];
+  }
+  sums[iCell] += weight;
+  return;
+
+}  // end 'Fill(double*, double)'
+
+
+
+inline void SCountCube::BuildIndex() {
+
+  // running sum along one dimension at a time: after
+  // dimension d, each cell holds the sum over all cells
+  // at or below it in dimensions 0...d
+  for (size_t iDim = 0; iDim < axes.size(); iDim++) {
+    const size_t nCells = axes[iDim].nBins + 2;
+    for (size_t iCell = 0; iCell < sums.size(); iCell++) {
+      const size_t iBin = (iCell / stride[iDim]) % nCells;
+      if (iBin > 0) sums[iCell] += sums[iCell - stride[iDim]];
+    }
+  }
+  isIndexed = true;
+  return;
+
+}  // end 'BuildIndex()'
+
+
+
+inline double SCountCube::Integral(const uint32_t* lo, const uint32_t* hi) const {
+
+  // inclusion-exclusion over the 2^N corners of the box
+  const size_t nDims    = axes.size();
+  const size_t nCorners = (size_t) 1 << nDims;
+
+  double integral = 0.;
+  for (size_t corner = 0; corner < nCorners; corner++) {
+    size_t iCell   = 0;
+    bool   isEmpty = false;
+    bool   isOdd   = false;
+    for (size_t iDim = 0; iDim < nDims; iDim++) {
+      if ((corner >> iDim) & 1) {
+        if (lo[iDim] == 0) {
+          isEmpty = true;
+          break;
+        }
+        iCell += (lo[iDim] - 1) * stride[iDim];
+        isOdd  = !isOdd;
+      } else {
+        iCell += hi[iDim] * stride[iDim];
+      }
+    }
+    if (isEmpty) continue;
+    integral += isOdd ? -sums[iCell] : sums[iCell];
+  }
+  return integral;
+
+}  // end 'Integral(uint32_t*, uint32_t*)'
+
+
+
+// pareto front ---------------------------------------------------------------
+
+// indices of the points which no other point beats in both
+// efficiency & rejection, in order of decreasing efficiency
+inline vector<size_t> GetParetoFront(const vector<double>& eff, const vector<double>& rej) {
+
+  vector<size_t> order(eff.size());
+  iota(order.begin(), order.end(), 0);
+  sort(order.begin(), order.end(), [&](const size_t a, const size_t b) {
+    return (eff[a] != eff[b]) ? (eff[a] > eff[b]) : (rej[a] > rej[b]);
+  });
+
+  // walking down in efficiency, a point is on the
+  // front if it has the best rejection seen so far
+  vector<size_t> front;
+  for (const size_t iPoint : order) {
+    if (front.empty() || (rej[iPoint] > rej[front.back()])) {
+      front.push_back(iPoint);
+    }
+  }
+  return front;
+
+}  // end 'GetParetoFront(vector<double>&, vector<double>&)'
+
+#endif
+
+// end ------------------------------------------------------------------------
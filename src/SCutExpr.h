@@ -0,0 +1,491 @@
+// ----------------------------------------------------------------------------
+// 'SCutExpr.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Small cut-expression language over tuple
+// columns, e.g.
+//
+//   "abs(dca3dxy / dca3dxysigma) < 3 && chisq / ndf < 5"
+//
+// An expression is parsed once into a typed
+// tree (numbers vs. booleans are checked at
+// parse time) and flattened into a postfix
+// program. The program is run over batches
+// of column values, one tight loop per
+// operation, instead of interpreting the
+// expression entry by entry.
+// ----------------------------------------------------------------------------
+
+#ifndef SCUTEXPR_H
+#define SCUTEXPR_H
+
+// standard c includes
+#include <cmath>
+#include <cctype>
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdint>
+#include <cstdlib>
+#include <algorithm>
+
+using namespace std;
+
+
+
+// SCutExpr definition --------------------------------------------------------
+
+class SCutExpr {
+
+  public:
+
+    // ctor
+    SCutExpr() {}
+
+    // parse & compile text, returns false (with
+    // a message in error) if text isn't valid
+    bool Parse(const string& text, string& error);
+
+    // pass[iRow] = 1 if row iRow passes, where
+    // columns[iCol][iRow] is the value of GetColumns()[iCol]
+    void Evaluate(const float* const* columns, const size_t nRows, uint8_t* pass) const;
+
+    // getters
+    bool                  IsEmpty()    const {return program.empty();}
+    const string&         GetText()    const {return source;}
+    const vector<string>& GetColumns() const {return columns;}
+
+  private:
+
+    // operations of compiled program
+    enum Op {Column, Constant, Neg, Abs, Sqrt, Not, Add, Sub, Mul, Div, Lt, Le, Gt, Ge, Eq, Ne, And, Or};
+
+    // types of (sub-)expressions
+    enum Type {Num, Bool};
+
+    // expression tree node
+    struct Node {
+      Op                       op      = Op::Constant;
+      Type                     type    = Type::Num;
+      size_t                   iColumn = 0;
+      float                    value   = 0.;
+      vector<unique_ptr<Node>> args;
+    };
+
+    // program instruction
+    struct Instr {
+      Op     op;
+      size_t iColumn;
+      float  value;
+    };
+
+    // recursive-descent parser
+    unique_ptr<Node> ParseOr();
+    unique_ptr<Node> ParseAnd();
+    unique_ptr<Node> ParseNot();
+    unique_ptr<Node> ParseCompare();
+    unique_ptr<Node> ParseSum();
+    unique_ptr<Node> ParseProduct();
+    unique_ptr<Node> ParseUnary();
+    unique_ptr<Node> ParseAtom();
+
+    // parser helpers
+    void             SkipSpace();
+    bool             Accept(const string& token);
+    void             Fail(const string& message);
+    unique_ptr<Node> MakeNode(const Op op, const Type type, unique_ptr<Node> lhs, unique_ptr<Node> rhs = nullptr);
+
+    // rows per block of evaluation
+    static constexpr size_t NBlock = 256;
+
+    // flatten tree into postfix program
+    void Compile(const Node* node, size_t depth);
+
+    // source & parser state
+    string source;
+    string message;
+    size_t iChar    = 0;
+    bool   isFailed = false;
+
+    // referenced columns & compiled program
+    vector<string> columns;
+    vector<Instr>  program;
+    size_t         nMaxDepth = 0;
+
+};  // end SCutExpr definition
+
+
+
+// SCutExpr parsing -----------------------------------------------------------
+
+inline bool SCutExpr::Parse(const string& text, string& error) {
+
+  source   = text;
+  iChar    = 0;
+  isFailed = false;
+  columns.clear();
+  program.clear();
+  nMaxDepth = 0;
+
+  // parse whole text as one boolean expression
+  unique_ptr<Node> root = ParseOr();
+  SkipSpace();
+  if (!isFailed && (iChar < source.size())) Fail("unexpected '" + source.substr(iChar, 1) + "'");
+  if (!isFailed && (root -> type != Type::Bool)) Fail("expression is a number, not a cut (missing comparison?)");
+  if (isFailed) {
+    error = message;
+    columns.clear();
+    return false;
+  }
+
+  Compile(root.get(), 1);
+  return true;
+
+}  // end 'Parse(string&, string&)'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::ParseOr() {
+
+  unique_ptr<SCutExpr::Node> lhs = ParseAnd();
+  while (!isFailed && Accept("||")) {
+    lhs = MakeNode(Op::Or, Type::Bool, move(lhs), ParseAnd());
+  }
+  return lhs;
+
+}  // end 'ParseOr()'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::ParseAnd() {
+
+  unique_ptr<SCutExpr::Node> lhs = ParseNot();
+  while (!isFailed && Accept("&&")) {
+    lhs = MakeNode(Op::And, Type::Bool, move(lhs), ParseNot());
+  }
+  return lhs;
+
+}  // end 'ParseAnd()'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::ParseNot() {
+
+  if (Accept("!")) return MakeNode(Op::Not, Type::Bool, ParseNot());
+  return ParseCompare();
+
+}  // end 'ParseNot()'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::ParseCompare() {
+
+  unique_ptr<SCutExpr::Node> lhs = ParseSum();
+
+  // two-character operators first
+  const vector<pair<string, Op>> compares = {
+    {"<=", Op::Le}, {">=", Op::Ge}, {"==", Op::Eq}, {"!=", Op::Ne}, {"<", Op::Lt}, {">", Op::Gt}
+  };
+  for (const pair<string, Op>& compare : compares) {
+    if (!isFailed && Accept(compare.first)) {
+      return MakeNode(compare.second, Type::Bool, move(lhs), ParseSum());
+    }
+  }
+  return lhs;
+
+}  // end 'ParseCompare()'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::ParseSum() {
+
+  unique_ptr<SCutExpr::Node> lhs = ParseProduct();
+  while (!isFailed) {
+    if (Accept("+")) {
+      lhs = MakeNode(Op::Add, Type::Num, move(lhs), ParseProduct());
+    } else if (Accept("-")) {
+      lhs = MakeNode(Op::Sub, Type::Num, move(lhs), ParseProduct());
+    } else {
+      break;
+    }
+  }
+  return lhs;
+
+}  // end 'ParseSum()'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::ParseProduct() {
+
+  unique_ptr<SCutExpr::Node> lhs = ParseUnary();
+  while (!isFailed) {
+    if (Accept("*")) {
+      lhs = MakeNode(Op::Mul, Type::Num, move(lhs), ParseUnary());
+    } else if (Accept("/")) {
+      lhs = MakeNode(Op::Div, Type::Num, move(lhs), ParseUnary());
+    } else {
+      break;
+    }
+  }
+  return lhs;
+
+}  // end 'ParseProduct()'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::ParseUnary() {
+
+  if (Accept("-")) return MakeNode(Op::Neg, Type::Num, ParseUnary());
+  if (Accept("+")) return ParseUnary();
+  return ParseAtom();
+
+}  // end 'ParseUnary()'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::ParseAtom() {
+
+  SkipSpace();
+  unique_ptr<SCutExpr::Node> atom(new Node());
+  if (isFailed) return atom;
+
+  // parenthesized expression (number or cut)
+  if (Accept("(")) {
+    atom = ParseOr();
+    if (!isFailed && !Accept(")")) Fail("missing ')'");
+    return atom;
+  }
+
+  // number
+  if ((iChar < source.size()) && (isdigit(source[iChar]) || (source[iChar] == '.'))) {
+    const char* start = source.c_str() + iChar;
+    char*       stop  = NULL;
+    atom -> op    = Op::Constant;
+    atom -> type  = Type::Num;
+    atom -> value = strtof(start, &stop);
+    iChar += stop - start;
+    return atom;
+  }
+
+  // column or function
+  if ((iChar < source.size()) && (isalpha(source[iChar]) || (source[iChar] == '_'))) {
+    const size_t iStart = iChar;
+    while ((iChar < source.size()) && (isalnum(source[iChar]) || (source[iChar] == '_'))) {
+      ++iChar;
+    }
+    const string name = source.substr(iStart, iChar - iStart);
+
+    // functions of one number
+    if (Accept("(")) {
+      Op function;
+      if (name == "abs") {
+        function = Op::Abs;
+      } else if (name == "sqrt") {
+        function = Op::Sqrt;
+      } else {
+        Fail("unknown function '" + name + "'");
+        return atom;
+      }
+      atom = MakeNode(function, Type::Num, ParseSum());
+      if (!isFailed && !Accept(")")) Fail("missing ')' after argument of '" + name + "'");
+      return atom;
+    }
+
+    // each column is read once, however often it appears
+    const auto found = find(columns.begin(), columns.end(), name);
+    atom -> op      = Op::Column;
+    atom -> type    = Type::Num;
+    atom -> iColumn = found - columns.begin();
+    if (found == columns.end()) columns.push_back(name);
+    return atom;
+  }
+
+  Fail((iChar < source.size()) ? ("unexpected '" + source.substr(iChar, 1) + "'") : "unexpected end of expression");
+  return atom;
+
+}  // end 'ParseAtom()'
+
+
+
+inline void SCutExpr::SkipSpace() {
+
+  while ((iChar < source.size()) && isspace(source[iChar])) {
+    ++iChar;
+  }
+  return;
+
+}  // end 'SkipSpace()'
+
+
+
+inline bool SCutExpr::Accept(const string& token) {
+
+  SkipSpace();
+  if (source.compare(iChar, token.size(), token) != 0) return false;
+
+  // don't split '<=' etc. when looking for '<'
+  const bool isSplit = ((token.size() == 1) && (token.find_first_of("<>=!") != string::npos) && (source.compare(iChar + 1, 1, "=") == 0));
+  if (isSplit) return false;
+
+  iChar += token.size();
+  return true;
+
+}  // end 'Accept(string&)'
+
+
+
+inline void SCutExpr::Fail(const string& text) {
+
+  if (isFailed) return;
+  isFailed = true;
+  message  = text + " (at character " + to_string(iChar) + " of '" + source + "')";
+  return;
+
+}  // end 'Fail(string&)'
+
+
+
+inline unique_ptr<SCutExpr::Node> SCutExpr::MakeNode(const Op op, const Type type, unique_ptr<Node> lhs, unique_ptr<Node> rhs) {
+
+  unique_ptr<Node> node(new Node());
+  node -> op   = op;
+  node -> type = type;
+  if (isFailed) return node;
+
+  // arithmetic & comparisons take numbers, logic takes cuts
+  const bool isLogic  = ((op == Op::Not) || (op == Op::And) || (op == Op::Or));
+  const Type typeArgs = isLogic ? Type::Bool : Type::Num;
+  if ((lhs -> type != typeArgs) || (rhs && (rhs -> type != typeArgs))) {
+    Fail(isLogic ? "'!', '&&', and '||' need cuts, not numbers" : "arithmetic and comparisons need numbers, not cuts");
+    return node;
+  }
+
+  node -> args.push_back(move(lhs));
+  if (rhs) node -> args.push_back(move(rhs));
+  return node;
+
+}  // end 'MakeNode(Op, Type, unique_ptr<Node>, unique_ptr<Node>)'
+
+
+
+inline void SCutExpr::Compile(const Node* node, size_t depth) {
+
+  // arguments first, each on its own level of the stack,
+  // leaving the result on this node's level
+  nMaxDepth = max(nMaxDepth, depth);
+  for (size_t iArg = 0; iArg < node -> args.size(); iArg++) {
+    Compile(node -> args[iArg].get(), depth + iArg);
+  }
+  program.push_back({node -> op, node -> iColumn, node -> value});
+  return;
+
+}  // end 'Compile(Node*, size_t)'
+
+
+
+// SCutExpr evaluation --------------------------------------------------------
+
+inline void SCutExpr::Evaluate(const float* const* columnValues, const size_t nRows, uint8_t* pass) const {
+
+  // one block-sized register per level of the stack: blocks
+  // have a fixed size so every loop below has a known trip
+  // count & vectorizes (the tail of the last block is padding)
+  vector<float> stack(nMaxDepth * NBlock, 0.f);
+  for (size_t iStart = 0; iStart < nRows; iStart += NBlock) {
+    const size_t nInBlock = min(NBlock, nRows - iStart);
+
+    size_t nUsed = 0;
+    for (const Instr& instr : program) {
+
+      // leaves push a register
+      if ((instr.op == Op::Column) || (instr.op == Op::Constant)) {
+        float* out = &stack[nUsed * NBlock];
+        if (instr.op == Op::Column) {
+          const float* in = columnValues[instr.iColumn] + iStart;
+          copy(in, in + nInBlock, out);
+          fill(out + nInBlock, out + NBlock, 0.f);
+        } else {
+          fill(out, out + NBlock, instr.value);
+        }
+        ++nUsed;
+        continue;
+      }
+
+      // unary operations work in place
+      float* __restrict__ a = &stack[(nUsed - 1) * NBlock];
+      switch (instr.op) {
+        case Op::Neg:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = -a[iRow];
+          continue;
+        case Op::Abs:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = abs(a[iRow]);
+          continue;
+        case Op::Sqrt:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = sqrt(a[iRow]);
+          continue;
+        case Op::Not:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = (a[iRow] == 0.f);
+          continue;
+        default:
+          break;
+      }
+
+      // binary operations write into the lower register
+      const float* __restrict__ b = a;
+      a = &stack[(nUsed - 2) * NBlock];
+      switch (instr.op) {
+        case Op::Add:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = a[iRow] + b[iRow];
+          break;
+        case Op::Sub:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = a[iRow] - b[iRow];
+          break;
+        case Op::Mul:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = a[iRow] * b[iRow];
+          break;
+        case Op::Div:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = a[iRow] / b[iRow];
+          break;
+        case Op::Lt:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = (a[iRow] < b[iRow]);
+          break;
+        case Op::Le:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = (a[iRow] <= b[iRow]);
+          break;
+        case Op::Gt:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = (a[iRow] > b[iRow]);
+          break;
+        case Op::Ge:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = (a[iRow] >= b[iRow]);
+          break;
+        case Op::Eq:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = (a[iRow] == b[iRow]);
+          break;
+        case Op::Ne:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = (a[iRow] != b[iRow]);
+          break;
+        case Op::And:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = ((a[iRow] != 0.f) & (b[iRow] != 0.f));
+          break;
+        case Op::Or:
+          for (size_t iRow = 0; iRow < NBlock; iRow++) a[iRow] = ((a[iRow] != 0.f) | (b[iRow] != 0.f));
+          break;
+        default:
+          break;
+      }
+      --nUsed;
+    }
+
+    // result is the bottom register
+    for (size_t iRow = 0; iRow < nInBlock; iRow++) {
+      pass[iStart + iRow] = (stack[iRow] != 0.f);
+    }
+  }
+  return;
+
+}  // end 'Evaluate(float**, size_t, uint8_t*)'
+
+#endif
+
+// end ------------------------------------------------------------------------
@@ -0,0 +1,179 @@
+// ----------------------------------------------------------------------------
+// 'SCutFlow.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Cut-flow accounting from a single pass:
+// each track is reduced to a mask with one
+// bit per cut it fails, and only the count
+// of each mask is kept. The sequential cut
+// flow, N-1 counts, and correlations between
+// cuts are all sums over those counts.
+// ----------------------------------------------------------------------------
+
+#ifndef SCUTFLOW_H
+#define SCUTFLOW_H
+
+// standard c includes
+#include <cmath>
+#include <vector>
+#include <cstdint>
+// root includes
+#include <TH1.h>
+#include <TH2.h>
+#include <TString.h>
+
+using namespace std;
+
+
+
+// SCutFlow definition --------------------------------------------------------
+
+class SCutFlow {
+
+  public:
+
+    // ctor
+    SCutFlow() {}
+
+    // set cut names (bit i of a mask is cut i) & clear counts
+    void Init(const vector<TString>& cutNames);
+
+    // count a track with a mask of the cuts it fails
+    inline void Add(const uint32_t failMask) {++counts[failMask];}
+
+    // no. of tracks which fail every cut in failBits
+    // & pass every cut in passBits
+    uint64_t Sum(const uint32_t failBits, const uint32_t passBits) const;
+
+    // derived counts: all tracks, tracks passing cuts
+    // 0...k-1, passing cut i alone, passing all but cut
+    // i (i.e. N-1), & failing both cuts i & j
+    uint64_t GetNTotal()                                  const {return Sum(0, 0);}
+    uint64_t GetNPassFirst(const size_t k)                const {return Sum(0, (1U << k) - 1);}
+    uint64_t GetNPass(const size_t i)                     const {return Sum(0, 1U << i);}
+    uint64_t GetNMinusOne(const size_t i)                 const {return Sum(0, GetAllBits() & ~(1U << i));}
+    uint64_t GetNFailBoth(const size_t i, const size_t j) const {return Sum((1U << i) | (1U << j), 0);}
+
+    // correlation coefficient of failing cuts i & j
+    double GetCorrelation(const size_t i, const size_t j) const;
+
+    // output histograms
+    TH1D* MakeFlowHist(const TString sName)        const;
+    TH1D* MakeNMinusOneHist(const TString sName)   const;
+    TH1D* MakeMaskHist(const TString sName)        const;
+    TH2D* MakeCorrelationHist(const TString sName) const;
+
+    // getters & setters
+    size_t                  GetNCuts()                 const {return names.size();}
+    uint32_t                GetAllBits()               const {return (1U << names.size()) - 1;}
+    const TString&          GetName(const size_t iCut) const {return names[iCut];}
+    const vector<uint64_t>& GetCounts()                const {return counts;}
+    void                    SetCount(const uint32_t mask, const uint64_t count) {counts[mask] = count;}
+
+  private:
+
+    // cut names & count of each fail mask
+    vector<TString>  names;
+    vector<uint64_t> counts;
+
+};  // end SCutFlow definition
+
+
+
+// SCutFlow implementation ----------------------------------------------------
+
+inline void SCutFlow::Init(const vector<TString>& cutNames) {
+
+  names = cutNames;
+  counts.assign((size_t) 1 << names.size(), 0);
+  return;
+
+}  // end 'Init(vector<TString>&)'
+
+
+
+inline uint64_t SCutFlow::Sum(const uint32_t failBits, const uint32_t passBits) const {
+
+  uint64_t sum = 0;
+  for (uint32_t mask = 0; mask < counts.size(); mask++) {
+    if (((mask & failBits) == failBits) && ((mask & passBits) == 0)) {
+      sum += counts[mask];
+    }
+  }
+  return sum;
+
+}  // end 'Sum(uint32_t, uint32_t)'
+
+
+
+inline double SCutFlow::GetCorrelation(const size_t i, const size_t j) const {
+
+  const double nAll  = GetNTotal();
+  const double nI    = nAll - GetNPass(i);
+  const double nJ    = nAll - GetNPass(j);
+  const double nBoth = GetNFailBoth(i, j);
+  const double denom = sqrt(nI * (nAll - nI) * nJ * (nAll - nJ));
+  return (denom > 0.) ? ((nAll * nBoth) - (nI * nJ)) / denom : 0.;
+
+}  // end 'GetCorrelation(size_t, size_t)'
+
+
+
+inline TH1D* SCutFlow::MakeFlowHist(const TString sName) const {
+
+  TH1D* hist = new TH1D(sName.Data(), "", names.size() + 1, 0., names.size() + 1.);
+  hist -> GetXaxis() -> SetBinLabel(1, "all");
+  hist -> SetBinContent(1, GetNTotal());
+  for (size_t iCut = 0; iCut < names.size(); iCut++) {
+    hist -> GetXaxis() -> SetBinLabel(iCut + 2, names[iCut].Data());
+    hist -> SetBinContent(iCut + 2, GetNPassFirst(iCut + 1));
+  }
+  return hist;
+
+}  // end 'MakeFlowHist(TString)'
+
+
+
+inline TH1D* SCutFlow::MakeNMinusOneHist(const TString sName) const {
+
+  TH1D* hist = new TH1D(sName.Data(), "", names.size(), 0., names.size());
+  for (size_t iCut = 0; iCut < names.size(); iCut++) {
+    hist -> GetXaxis() -> SetBinLabel(iCut + 1, names[iCut].Data());
+    hist -> SetBinContent(iCut + 1, GetNMinusOne(iCut));
+  }
+  return hist;
+
+}  // end 'MakeNMinusOneHist(TString)'
+
+
+
+inline TH1D* SCutFlow::MakeMaskHist(const TString sName) const {
+
+  TH1D* hist = new TH1D(sName.Data(), "", counts.size(), 0., counts.size());
+  for (size_t mask = 0; mask < counts.size(); mask++) {
+    hist -> SetBinContent(mask + 1, counts[mask]);
+  }
+  return hist;
+
+}  // end 'MakeMaskHist(TString)'
+
+
+
+inline TH2D* SCutFlow::MakeCorrelationHist(const TString sName) const {
+
+  TH2D* hist = new TH2D(sName.Data(), "", names.size(), 0., names.size(), names.size(), 0., names.size());
+  for (size_t iCut = 0; iCut < names.size(); iCut++) {
+    hist -> GetXaxis() -> SetBinLabel(iCut + 1, names[iCut].Data());
+    hist -> GetYaxis() -> SetBinLabel(iCut + 1, names[iCut].Data());
+    for (size_t jCut = 0; jCut < names.size(); jCut++) {
+      hist -> SetBinContent(iCut + 1, jCut + 1, GetCorrelation(iCut, jCut));
+    }
+  }
+  return hist;
+
+}  // end 'MakeCorrelationHist(TString)'
+
+#endif
+
+// end ------------------------------------------------------------------------
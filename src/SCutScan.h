@@ -0,0 +1,218 @@
+// ----------------------------------------------------------------------------
+// 'SCutScan.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Single-pass scan over a grid of values
+// for each of the general track cuts. Each
+// track is reduced to the tightest value
+// of each cut it still passes, and counted
+// once in that cell of a cube. Suffix sums
+// along every cut then give the counts
+// passing every grid point at once.
+// ----------------------------------------------------------------------------
+
+#ifndef SCUTSCAN_H
+#define SCUTSCAN_H
+
+// standard c includes
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <functional>
+// user includes
+#include "SVariantHist.h"
+
+using namespace std;
+
+
+
+// SCutScan definition --------------------------------------------------------
+
+class SCutScan {
+
+  public:
+
+    // general cuts, in the order of SetGeneralTrackCuts()
+    enum Cut {Intt, MVtx, Tpc, Qual, ZVtx, Pt, NCut};
+
+    // ctor
+    SCutScan() {}
+
+    // set grids (sorted loosest to tightest here), no. of
+    // count variants per point, & axis of pt spectra
+    void Init(const array<vector<double>, Cut::NCut>& grids, const size_t nVariants, const SVariantAxis& axSpectra);
+
+    // tightest grid index of each cut a track passes,
+    // false if the track fails the loosest value of any
+    inline bool GetLevels(const array<double, Cut::NCut>& values, array<uint32_t, Cut::NCut>& levels) const;
+
+    // count a track in its cell: variants are given as a
+    // mask, isNormal picks the normal vs. weird count
+    void Add(const array<uint32_t, Cut::NCut>& levels, const uint64_t variants, const bool isNormal, const double ptSpectra);
+
+    // turn per-cell counts into counts passing each grid point
+    void Accumulate();
+
+    // getters
+    size_t GetNPoints()   const {return nPoints;}
+    size_t GetNVariants() const {return nVar;}
+    double GetCutValue(const size_t iPoint, const size_t iCut) const;
+    double GetNNorm(const size_t iPoint, const size_t iVar)    const {return nNorm[(iPoint * nVar) + iVar];}
+    double GetNWeird(const size_t iPoint, const size_t iVar)   const {return nWeird[(iPoint * nVar) + iVar];}
+    const double*       GetSpectrum(const size_t iPoint) const {return &spectra[iPoint * (axSpec.nBins + 2)];}
+    const SVariantAxis& GetSpectrumAxis()                const {return axSpec;}
+
+    // does value pass cut (same comparisons as the track loops)
+    static bool Passes(const size_t iCut, const double value, const double cut);
+
+  private:
+
+    // suffix sums of a cube with inner blocks of nInner
+    void SuffixSum(vector<double>& cube, const size_t nInner) const;
+
+    // grids & strides
+    array<vector<double>, Cut::NCut> grid;
+    array<size_t, Cut::NCut>         stride;
+    size_t                           nPoints = 0;
+    size_t                           nVar    = 0;
+
+    // counts & spectra per cell
+    SVariantAxis   axSpec;
+    vector<double> nNorm;
+    vector<double> nWeird;
+    vector<double> spectra;
+
+};  // end SCutScan definition
+
+
+
+// SCutScan implementation ----------------------------------------------------
+
+inline bool SCutScan::Passes(const size_t iCut, const double value, const double cut) {
+
+  switch (iCut) {
+    case Cut::Intt:
+      return (value >= cut);
+    case Cut::Qual:
+    case Cut::ZVtx:
+      return (value < cut);
+    default:
+      return (value > cut);
+  }
+
+}  // end 'Passes(size_t, double, double)'
+
+
+
+inline void SCutScan::Init(const array<vector<double>, Cut::NCut>& grids, const size_t nVariants, const SVariantAxis& axSpectra) {
+
+  // lower cuts get looser as they go down, upper cuts as they go up
+  grid = grids;
+  for (size_t iCut = 0; iCut < Cut::NCut; iCut++) {
+    const bool isUpper = ((iCut == Cut::Qual) || (iCut == Cut::ZVtx));
+    if (isUpper) {
+      sort(grid[iCut].begin(), grid[iCut].end(), greater<double>());
+    } else {
+      sort(grid[iCut].begin(), grid[iCut].end());
+    }
+  }
+
+  // last cut runs fastest
+  nPoints = 1;
+  for (int iCut = Cut::NCut - 1; iCut >= 0; iCut--) {
+    stride[iCut] = nPoints;
+    nPoints     *= grid[iCut].size();
+  }
+
+  nVar   = nVariants;
+  axSpec = axSpectra;
+  nNorm.assign(nPoints * nVar, 0.);
+  nWeird.assign(nPoints * nVar, 0.);
+  spectra.assign(nPoints * (axSpec.nBins + 2), 0.);
+  return;
+
+}  // end 'Init(array<vector<double>, NCut>&, size_t, SVariantAxis&)'
+
+
+
+inline bool SCutScan::GetLevels(const array<double, Cut::NCut>& values, array<uint32_t, Cut::NCut>& levels) const {
+
+  for (size_t iCut = 0; iCut < Cut::NCut; iCut++) {
+    uint32_t nPass = 0;
+    while ((nPass < grid[iCut].size()) && Passes(iCut, values[iCut], grid[iCut][nPass])) {
+      ++nPass;
+    }
+    if (nPass == 0) return false;
+    levels[iCut] = nPass - 1;
+  }
+  return true;
+
+}  // end 'GetLevels(array<double, NCut>&, array<uint32_t, NCut>&)'
+
+
+
+inline void SCutScan::Add(const array<uint32_t, Cut::NCut>& levels, const uint64_t variants, const bool isNormal, const double ptSpectra) {
+
+  size_t iCell = 0;
+  for (size_t iCut = 0; iCut < Cut::NCut; iCut++) {
+    iCell += levels[iCut] * stride[iCut];
+  }
+
+  vector<double>& counts = isNormal ? nNorm : nWeird;
+  for (uint64_t mask = variants; mask != 0; mask &= (mask - 1)) {
+    counts[(iCell * nVar) + __builtin_ctzll(mask)] += 1.;
+  }
+  spectra[(iCell * (axSpec.nBins + 2)) + axSpec.FindBin(ptSpectra)] += 1.;
+  return;
+
+}  // end 'Add(array<uint32_t, NCut>&, uint64_t, bool, double)'
+
+
+
+inline void SCutScan::Accumulate() {
+
+  SuffixSum(nNorm, nVar);
+  SuffixSum(nWeird, nVar);
+  SuffixSum(spectra, axSpec.nBins + 2);
+  return;
+
+}  // end 'Accumulate()'
+
+
+
+inline double SCutScan::GetCutValue(const size_t iPoint, const size_t iCut) const {
+
+  return grid[iCut][(iPoint / stride[iCut]) % grid[iCut].size()];
+
+}  // end 'GetCutValue(size_t, size_t)'
+
+
+
+inline void SCutScan::SuffixSum(vector<double>& cube, const size_t nInner) const {
+
+  // a track passing level l of a cut passes every
+  // grid value up to l, so sum tighter cells into
+  // looser ones, one cut at a time
+  for (size_t iCut = 0; iCut < Cut::NCut; iCut++) {
+    const size_t nLevels = grid[iCut].size();
+    const size_t step    = stride[iCut] * nInner;
+    for (size_t iPoint = nPoints; iPoint-- > 0;) {
+      const size_t iLevel = (iPoint / stride[iCut]) % nLevels;
+      if ((iLevel + 1) == nLevels) continue;
+
+      double*       cell  = &cube[iPoint * nInner];
+      const double* above = cell + step;
+      for (size_t iInner = 0; iInner < nInner; iInner++) {
+        cell[iInner] += above[iInner];
+      }
+    }
+  }
+  return;
+
+}  // end 'SuffixSum(vector<double>&, size_t)'
+
+#endif
+
+// end ------------------------------------------------------------------------
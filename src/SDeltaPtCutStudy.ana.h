@@ -17,14 +17,163 @@ using namespace std;
 
 // analysis methods -----------------------------------------------------------
 
+void SDeltaPtCutStudy::EvaluateCutExpression() {
+
+  // announce start of pass
+  cout << "      Evaluating cut expression over reco. tracks:" << endl;
+
+  // only read columns the expression needs
+  ntTrack -> SetBranchStatus("*", false);
+  for (const string& column : cutExpr.GetColumns()) {
+    ntTrack -> SetBranchStatus(column.c_str(), true);
+  }
+
+  // gather columns into batches, and evaluate batch by batch
+  const size_t          nBatch   = 4096;
+  const size_t          nColumns = exprAddresses.size();
+  vector<vector<float>> batch(nColumns, vector<float>(nBatch, 0.));
+  vector<const float*>  batchColumns(nColumns);
+  for (size_t iColumn = 0; iColumn < nColumns; iColumn++) {
+    batchColumns[iColumn] = batch[iColumn].data();
+  }
+
+  passExpr.assign(nTrks, 0);
+  uint64_t iBatchStart = 0;
+  uint64_t nPass       = 0;
+  for (uint64_t iTrk = 0; iTrk < nTrks; iTrk++) {
+
+    // stop cleanly if interrupted (unevaluated tracks fail)
+    if (isInterrupted) {
+      cout << "        Interrupted at track " << iTrk << "/" << nTrks << "! Stopping pass." << endl;
+      break;
+    }
+
+    ntTrack -> GetEntry(iTrk);
+    for (size_t iColumn = 0; iColumn < nColumns; iColumn++) {
+      batch[iColumn][iTrk - iBatchStart] = *exprAddresses[iColumn];
+    }
+
+    // evaluate full (or last) batch
+    const size_t nInBatch = (iTrk - iBatchStart) + 1;
+    if ((nInBatch == nBatch) || ((iTrk + 1) == nTrks)) {
+      cutExpr.Evaluate(batchColumns.data(), nInBatch, &passExpr[iBatchStart]);
+      for (size_t iInBatch = 0; iInBatch < nInBatch; iInBatch++) {
+        nPass += passExpr[iBatchStart + iInBatch];
+      }
+      iBatchStart = iTrk + 1;
+    }
+  }
+
+  // restore all columns for track loops
+  ntTrack -> SetBranchStatus("*", true);
+
+  cout << "      Cut expression passed by " << nPass << "/" << nTrks << " reco. tracks." << endl;
+  return;
+
+}  // end 'EvaluateCutExpression()'
+
+
+
+void SDeltaPtCutStudy::BuildTruthIndex() {
+
+  // announce start of pass
+  cout << "      Indexing particles by (event, gtrackID):" << endl;
+
+  // only read columns the index needs
+  ntTruth -> SetBranchStatus("*", false);
+  ntTruth -> SetBranchStatus("event", true);
+  ntTruth -> SetBranchStatus("gtrackID", true);
+  ntTruth -> SetBranchStatus("gprimary", true);
+  ntTruth -> SetBranchStatus("gpt", true);
+
+  truIndex.Reserve(nTrus);
+  truEvent.clear();
+  truPt.clear();
+  truPrimary.clear();
+  truEvent.reserve(nTrus);
+  truPt.reserve(nTrus);
+  truPrimary.reserve(nTrus);
+
+  uint64_t nRepeat = 0;
+  for (uint64_t iTru = 0; iTru < nTrus; iTru++) {
+
+    // stop cleanly if interrupted
+    if (isInterrupted) {
+      cout << "        Interrupted at particle " << iTru << "/" << nTrus << "! Stopping pass." << endl;
+      break;
+    }
+
+    ntTruth -> GetEntry(iTru);
+    truEvent.push_back((uint32_t) tru_event);
+    truPt.push_back(tru_gpt);
+    truPrimary.push_back(tru_gprimary == 1);
+    if (!truIndex.Insert(STruthIndex::MakeKey((uint32_t) tru_event, (int32_t) tru_gtrackID), iTru)) ++nRepeat;
+  }
+  nTruMatch.assign(truPt.size() * (nDPtCuts + 1), 0);
+
+  // restore all columns for truth loop
+  ntTruth -> SetBranchStatus("*", true);
+
+  if (nRepeat > 0) {
+    cerr << "WARNING: " << nRepeat << " particles repeat an (event, gtrackID) already indexed! Tracks will match the 1st one." << endl;
+  }
+  cout << "      Indexed " << truIndex.GetSize() << " particles." << endl;
+  return;
+
+}  // end 'BuildTruthIndex()'
+
+
+
 void SDeltaPtCutStudy::ApplyFlatDeltaPtCuts() {
 
   // announce start of track loop
   cout << "      First loop over reco. tracks:" << endl;
 
+  // buffer for batched filling, & threads for buffered or
+  // deferred fills (both owned by this loop, so threads are reused)
+  SFillBuffer    buffer(axFillCols, nFillBuffer);
+  const SFitPool pool((doFillBuffer || doDeferHists) ? nFillThreads : 1);
+
+  // resume from checkpoint if needed
+  const uint64_t iStartTrk = (ckptStage == Stage::SFlat) ? ckptEntry : 0;
+  ckptLastEntry = iStartTrk;
+
+  // scan & matching only see tracks from where the loop starts
+  if (doCutScan && (iStartTrk > 0)) {
+    cerr << "WARNING: resuming 1st track loop at track " << iStartTrk << ", general cut scan won't include earlier tracks!" << endl;
+  }
+  if (doTruthMatch && (iStartTrk > 0)) {
+    cerr << "WARNING: resuming 1st track loop at track " << iStartTrk << ", truth matching won't include earlier tracks!" << endl;
+  }
+  if (doSectorMask && (iStartTrk > 0)) {
+    cerr << "WARNING: resuming 1st track loop at track " << iStartTrk << ", sector mask comparison won't include earlier tracks!" << endl;
+  }
+
+  // prepare track store if needed (restored store is kept)
+  if (doTrackStore && (iStartTrk == 0)) {
+    trkStore.Clear();
+    trkStore.Reserve(nTrks);
+  }
+
   // 1st track loop
   uint64_t nBytesTrk = 0;
-  for (uint64_t iTrk = 0; iTrk < nTrks; iTrk++) {
+  nProcFlat = nTrks;
+  for (uint64_t iTrk = iStartTrk; iTrk < nTrks; iTrk++) {
+
+    // stop cleanly if interrupted
+    if (isInterrupted) {
+      cout << "\n        Interrupted at track " << iTrk << "/" << nTrks << "! Stopping loop." << endl;
+      nProcFlat = iTrk;
+      buffer.Flush(vhPtCut, vhFillCols, pool);
+      WriteCheckpoint(Stage::SFlat, iTrk);
+      break;
+    }
+
+    // write checkpoint if due
+    if (IsCheckpointDue(iTrk)) {
+      buffer.Flush(vhPtCut, vhFillCols, pool);
+      WriteCheckpoint(Stage::SFlat, iTrk);
+    }
 
     // grab entry
     const uint64_t bytesTrk = ntTrack -> GetEntry(iTrk);
@@ -42,56 +191,115 @@ void SDeltaPtCutStudy::ApplyFlatDeltaPtCuts() {
       cout << "        Processing track " << iProgTrk << "/" << nTrks << "...\r" << flush;
     }
 
-    // do calculations
-    const double ptFrac  = trk_pt / trk_gpt;
-    const double ptDelta = trk_deltapt / trk_pt;
-
-    // apply trk cuts
-    const bool isInZVtxCut = (abs(trk_vz) <  vzTrkMax);
-    const bool isInInttCut = (trk_nintt   >= nInttTrkMin);
-    const bool isInMVtxCut = (trk_nlmaps  >  nMVtxTrkMin);
-    const bool isInTpcCut  = (trk_ntpc    >  nTpcTrkMin);
-    const bool isInPtCut   = (trk_pt      >  ptTrkMin);
-    const bool isInQualCut = (trk_quality <  qualTrkMax);
-    const bool isGoodTrk   = (isInZVtxCut && isInInttCut && isInMVtxCut && isInTpcCut && isInPtCut && isInQualCut);
-    if (!isGoodTrk) continue;
+    // apply trk cuts & cut expression, and count
+    // which combination of them the track fails
+    const bool isInExprCut = (!doCutExpr || passExpr[iTrk]);
+    uint32_t   failCuts    = GetGeneralCutMask();
+    if (!isInExprCut) failCuts |= bitExpr;
+    cutFlow.Add(failCuts);
+    if (!isInExprCut) continue;
 
-    // fill histograms
-    hPtDelta        -> Fill(ptDelta);
-    hPtTrack        -> Fill(trk_pt);
-    hPtFrac         -> Fill(ptFrac);
-    hPtTrkTru       -> Fill(trk_gpt);
-    hPtDeltaVsFrac  -> Fill(ptFrac,  ptDelta);
-    hPtDeltaVsTrue  -> Fill(trk_gpt, ptDelta);
-    hPtDeltaVsTrack -> Fill(trk_pt,  ptDelta);
-    hPtTrueVsTrack  -> Fill(trk_pt,  trk_gpt);
+    // do calculations
+    const double ptFrac    = trk_pt / trk_gpt;
+    const double ptDelta   = trk_deltapt / trk_pt;
+    const bool   isGoodTrk = (failCuts == 0);
 
     // apply delta-pt cuts
     const bool isNormalTrk = ((ptFrac > normRange[0]) && (ptFrac < normRange[1]));
+    uint64_t   passCuts    = 0;
     for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
       const bool isInDeltaPtCut = (ptDelta < ptDeltaMax[iCut]);
-      if (isInDeltaPtCut) {
-
-        // fill histograms
-        hPtDeltaCut[iCut]        -> Fill(ptDelta);
-        hPtTrackCut[iCut]        -> Fill(trk_pt);
-        hPtFracCut[iCut]         -> Fill(ptFrac);
-        hPtTrkTruCut[iCut]       -> Fill(trk_gpt);
-        hPtDeltaVsFracCut[iCut]  -> Fill(ptFrac,  ptDelta);
-        hPtDeltaVsTrueCut[iCut]  -> Fill(trk_gpt, ptDelta);
-        hPtDeltaVsTrackCut[iCut] -> Fill(trk_pt,  ptDelta);
-        hPtTrueVsTrackCut[iCut]  -> Fill(trk_pt,  trk_gpt);
-
-        // increment counters
+      if (isInDeltaPtCut) passCuts |= (1ULL << iCut);
+    }
+
+    // count track at every scan point it passes (tracks
+    // in the sector mask are out at every point)
+    const bool isInSecMask = (doSectorMask && ((failCuts & bitSector) != 0));
+    if (doCutScan && !isInSecMask) {
+      const array<double, SCutScan::Cut::NCut> cutValues = {trk_nintt, trk_nlmaps, trk_ntpc, trk_quality, abs(trk_vz), trk_pt};
+      array<uint32_t, SCutScan::Cut::NCut>     cutLevels;
+      if (cutScan.GetLevels(cutValues, cutLevels)) {
+        cutScan.Add(cutLevels, passCuts | (1ULL << nDPtCuts), isNormalTrk, trk_gpt);
+      }
+    }
+
+    // compare tracks passing all other cuts with & without sector mask
+    if (doSectorMask && ((failCuts & ~bitSector) == 0)) {
+      hPtDeltaNoMask  -> Fill(ptDelta);
+      hSectorDistance -> Fill(sectorMask.GetDistance(trk_phi));
+      if (isGoodTrk) hPtDeltaWithMask -> Fill(ptDelta);
+      for (uint64_t mask = passCuts; mask != 0; mask &= (mask - 1)) {
+        const size_t iCut = __builtin_ctzll(mask);
         if (isNormalTrk) {
-          ++nNormCut[iCut];
+          ++nNormNoMask[iCut];
         } else {
-          ++nWeirdCut[iCut];
+          ++nWeirdNoMask[iCut];
         }
       }
+    }
+    if (!isGoodTrk) continue;
+
+    // increment counters (& their bootstrap replicas)
+    if (doBootstrap) boot.SetUnit((uint64_t) trk_event);
+    for (uint64_t mask = passCuts; mask != 0; mask &= (mask - 1)) {
+      const size_t iCut = __builtin_ctzll(mask);
+      if (isNormalTrk) {
+        ++nNormCut[iCut];
+      } else {
+        ++nWeirdCut[iCut];
+      }
+      if (doBootstrap) boot.Add(GetBootCounter(isNormalTrk ? Boot::BNormCut : Boot::BWeirdCut, iCut));
     }  // end delta-pt cut
+
+    // join track to its truth particle
+    if (doTruthMatch) MatchTrackToTruth(passCuts | (1ULL << nDPtCuts));
+
+    // store track, and defer filling if needed
+    if (doTrackStore) trkStore.Add(trk_pt, trk_gpt, trk_deltapt, trk_quality, trk_nlmaps, trk_ntpc, trk_event, trk_gtrackID, passCuts);
+    if (doDeferHists) continue;
+
+    // in buffered mode, fill when buffer is full
+    if (doFillBuffer) {
+      const double trkValues[Col::NCol] = {ptDelta, trk_pt, ptFrac, trk_gpt};
+      buffer.Add(trkValues, passCuts | (1ULL << nDPtCuts));
+      if (buffer.IsFull()) buffer.Flush(vhPtCut, vhFillCols, pool);
+      continue;
+    }
+
+    // find bins once per track: every histogram shares these axes
+    const uint32_t iBinDelta        = axDelta.FindBin(ptDelta);
+    const uint32_t iBinTrack        = axPt.FindBin(trk_pt);
+    const uint32_t iBinFrac         = axFrac.FindBin(ptFrac);
+    const uint32_t iBinTrkTru       = axPt.FindBin(trk_gpt);
+    const uint64_t iBinDeltaVsFrac  = vhPtCut[Hist::HDeltaVsFrac].GetBin(iBinFrac,   iBinDelta);
+    const uint64_t iBinDeltaVsTrue  = vhPtCut[Hist::HDeltaVsTrue].GetBin(iBinTrkTru, iBinDelta);
+    const uint64_t iBinDeltaVsTrack = vhPtCut[Hist::HDeltaVsTrack].GetBin(iBinTrack, iBinDelta);
+    const uint64_t iBinTrueVsTrack  = vhPtCut[Hist::HTrueVsTrack].GetBin(iBinTrack,  iBinTrkTru);
+
+    // fill no-cut & passing cut variants (no-cut is the last slot)
+    for (uint64_t mask = passCuts | (1ULL << nDPtCuts); mask != 0; mask &= (mask - 1)) {
+      const size_t iCut = __builtin_ctzll(mask);
+      vhPtCut[Hist::HDelta].Fill(iCut, iBinDelta);
+      vhPtCut[Hist::HTrack].Fill(iCut, iBinTrack);
+      vhPtCut[Hist::HFrac].Fill(iCut, iBinFrac);
+      vhPtCut[Hist::HTrkTru].Fill(iCut, iBinTrkTru);
+      vhPtCut[Hist::HDeltaVsFrac].Fill(iCut, iBinDeltaVsFrac);
+      vhPtCut[Hist::HDeltaVsTrue].Fill(iCut, iBinDeltaVsTrue);
+      vhPtCut[Hist::HDeltaVsTrack].Fill(iCut, iBinDeltaVsTrack);
+      vhPtCut[Hist::HTrueVsTrack].Fill(iCut, iBinTrueVsTrack);
+    }
   }  // end 1st track loop
 
+  // fill from store if deferred, then
+  // flush remaining buffered tracks
+  if (doDeferHists) {
+    FillHistsFromStore(vhPtCut, trkStore.passCut, (1ULL << nDPtCuts), pool);
+  }
+  buffer.Flush(vhPtCut, vhFillCols, pool);
+
+  // export no-cut & cut variants into output histograms
+  ExportFlatCutHists();
+
   cout << "      First loop over reco. tracks finished!" << endl;
   return;
 
@@ -99,75 +307,291 @@ void SDeltaPtCutStudy::ApplyFlatDeltaPtCuts() {
 
 
 
+void SDeltaPtCutStudy::SkipFlatDeltaPtCuts() {
+
+  // 2nd loop can't run over the store if it wasn't filled
+  if (doTrackStore) {
+    cerr << "WARNING: 1st track loop skipped, so track store is turned off." << endl;
+    doTrackStore = false;
+    doDeferHists = false;
+  }
+  if (doCutScan) {
+    cerr << "WARNING: 1st track loop skipped, so general cut scan is skipped." << endl;
+  }
+  if (doTruthMatch) {
+    cerr << "WARNING: 1st track loop skipped, so truth matching is skipped." << endl;
+  }
+  if (doSectorMask) {
+    cerr << "WARNING: 1st track loop skipped, so sector mask comparison is skipped." << endl;
+  }
+  ExportFlatCutHists();
+  nProcFlat   = 0;
+  hasFlatLoop = false;
+
+  cout << "      Skipped first loop over reco. tracks (bands are cached)." << endl;
+  return;
+
+}  // end 'SkipFlatDeltaPtCuts()'
+
+
+
+void SDeltaPtCutStudy::RebuildFlatDeltaPtCuts() {
+
+  // announce start of rebuild
+  cout << "      Rebuilding flat delta-pt cut histograms from track store:" << endl;
+
+  // grab stored (good) tracks & their flat-cut decisions
+  ReadTrackStore();
+  if (doSectorMask) {
+    cerr << "WARNING: rebuilding from track store, so sector mask comparison is skipped." << endl;
+  }
+
+  // recount tracks passing each cut
+  for (size_t iTrk = 0; iTrk < trkStore.GetSize(); iTrk++) {
+    const double ptFrac      = trkStore.GetPtFrac(iTrk);
+    const bool   isNormalTrk = ((ptFrac > normRange[0]) && (ptFrac < normRange[1]));
+    for (uint64_t mask = trkStore.passCut[iTrk]; mask != 0; mask &= (mask - 1)) {
+      const size_t iCut = __builtin_ctzll(mask);
+      if (isNormalTrk) {
+        ++nNormCut[iCut];
+      } else {
+        ++nWeirdCut[iCut];
+      }
+    }
+  }
+
+  // fill & export no-cut & cut variants
+  const SFitPool pool(nFillThreads);
+  FillHistsFromStore(vhPtCut, trkStore.passCut, (1ULL << nDPtCuts), pool);
+  ExportFlatCutHists();
+  nProcFlat   = 0;
+  hasFlatLoop = false;
+
+  cout << "      Rebuilt flat delta-pt cut histograms." << endl;
+  return;
+
+}  // end 'RebuildFlatDeltaPtCuts()'
+
+
+
+void SDeltaPtCutStudy::RebuildPtDependentDeltaPtCuts() {
+
+  // announce start of rebuild: stored decisions were made with
+  // the bands of the earlier run, the new bands are only drawn
+  cout << "      Rebuilding pt-dependent delta-pt cut histograms from track store:" << endl;
+
+  // recount tracks passing each cut
+  for (size_t iTrk = 0; iTrk < trkStore.GetSize(); iTrk++) {
+    const double ptFrac      = trkStore.GetPtFrac(iTrk);
+    const bool   isNormalTrk = ((ptFrac > normRange[0]) && (ptFrac < normRange[1]));
+    for (uint64_t mask = trkStore.passSig[iTrk]; mask != 0; mask &= (mask - 1)) {
+      const size_t iSig = __builtin_ctzll(mask);
+      if (isNormalTrk) {
+        ++nNormSig[iSig];
+      } else {
+        ++nWeirdSig[iSig];
+      }
+    }
+  }
+
+  // fill & export cut variants
+  const SFitPool pool(nFillThreads);
+  InitSigmaEngines();
+  FillHistsFromStore(vhPtSig, trkStore.passSig, 0, pool);
+  ExportSigmaCutHists();
+  nProcSigma = trkStore.GetSize();
+
+  cout << "      Rebuilt pt-dependent delta-pt cut histograms." << endl;
+  return;
+
+}  // end 'RebuildPtDependentDeltaPtCuts()'
+
+
+
 void SDeltaPtCutStudy::ApplyPtDependentDeltaPtCuts() {
 
   // announce start of track loop
-  cout << "      Second loop over reco. tracks:" << endl;
+  if (doTrackStore) {
+    cout << "      Second loop over stored tracks:" << endl;
+  } else {
+    cout << "      Second loop over reco. tracks:" << endl;
+  }
+
+  // engines only exist while this loop runs
+  InitSigmaEngines();
+  if (ckptStage == Stage::SSigma) ReadCheckpointSigmaHists();
+
+  // buffer for batched filling, & threads for buffered or
+  // deferred fills (both owned by this loop, so threads are reused)
+  SFillBuffer    buffer(axFillCols, nFillBuffer);
+  const SFitPool pool((doFillBuffer || doDeferHists) ? nFillThreads : 1);
+
+  // with a track store, loop over stored (good) tracks instead of tuple
+  const uint64_t nLoop = doTrackStore ? trkStore.GetSize() : nTrks;
+
+  // resume from checkpoint if needed
+  const uint64_t iStartTrk = (ckptStage == Stage::SSigma) ? ckptEntry : 0;
+  ckptLastEntry = iStartTrk;
 
   // 2nd track loop
   uint64_t nBytesTrk = 0;
-  for (uint64_t iTrk = 0; iTrk < nTrks; iTrk++) {
-
-    // grab entry
-    const uint64_t bytesTrk = ntTrack -> GetEntry(iTrk);
-    if (bytesTrk < 0.) {
-      cerr << "WARNING: something wrong with track #" << iTrk << "! Aborting loop!" << endl;
+  nProcSigma = nLoop;
+  for (uint64_t iTrk = iStartTrk; iTrk < nLoop; iTrk++) {
+
+    // stop cleanly if interrupted
+    if (isInterrupted) {
+      cout << "\n        Interrupted at track " << iTrk << "/" << nLoop << "! Stopping loop." << endl;
+      nProcSigma = iTrk;
+      buffer.Flush(vhPtSig, vhFillCols, pool);
+      WriteCheckpoint(Stage::SSigma, iTrk);
       break;
     }
-    nBytesTrk += bytesTrk;
+
+    // write checkpoint if due
+    if (IsCheckpointDue(iTrk)) {
+      buffer.Flush(vhPtSig, vhFillCols, pool);
+      WriteCheckpoint(Stage::SSigma, iTrk);
+    }
 
     // announce progress
     const uint64_t iProgTrk = iTrk + 1;
-    if (iProgTrk == nTrks) {
-      cout << "        Processing track " << iProgTrk << "/" << nTrks << "..." << endl;
+    if (iProgTrk == nLoop) {
+      cout << "        Processing track " << iProgTrk << "/" << nLoop << "..." << endl;
     } else {
-      cout << "        Processing track " << iProgTrk << "/" << nTrks << "...\r" << flush;
+      cout << "        Processing track " << iProgTrk << "/" << nLoop << "...\r" << flush;
+    }
+
+    // grab track from store or tuple
+    float ptTrk;
+    float gptTrk;
+    float deltaTrk;
+    float qualTrk;
+    float nmvtxTrk;
+    float ntpcTrk;
+    float eventTrk;
+    if (doTrackStore) {
+      ptTrk    = trkStore.pt[iTrk];
+      gptTrk   = trkStore.gpt[iTrk];
+      deltaTrk = trkStore.deltapt[iTrk];
+      qualTrk  = trkStore.quality[iTrk];
+      nmvtxTrk = trkStore.nmvtx[iTrk];
+      ntpcTrk  = trkStore.ntpc[iTrk];
+      eventTrk = trkStore.event[iTrk];
+    } else {
+
+      // grab entry
+      const uint64_t bytesTrk = ntTrack -> GetEntry(iTrk);
+      if (bytesTrk < 0.) {
+        cerr << "WARNING: something wrong with track #" << iTrk << "! Aborting loop!" << endl;
+        break;
+      }
+      nBytesTrk += bytesTrk;
+
+      // apply trk cuts
+      const bool isInExprCut = (!doCutExpr || passExpr[iTrk]);
+      const bool isGoodTrk   = ((GetGeneralCutMask() == 0) && isInExprCut);
+      if (!isGoodTrk) continue;
+
+      ptTrk    = trk_pt;
+      gptTrk   = trk_gpt;
+      deltaTrk = trk_deltapt;
+      qualTrk  = trk_quality;
+      nmvtxTrk = trk_nlmaps;
+      ntpcTrk  = trk_ntpc;
+      eventTrk = trk_event;
     }
 
     // do calculations
-    const double ptFrac  = trk_pt / trk_gpt;
-    const double ptDelta = trk_deltapt / trk_pt;
-
-    // apply trk cuts
-    const bool isInZVtxCut = (abs(trk_vz) <  vzTrkMax);
-    const bool isInInttCut = (trk_nintt   >= nInttTrkMin);
-    const bool isInMVtxCut = (trk_nlmaps  >  nMVtxTrkMin);
-    const bool isInTpcCut  = (trk_ntpc    >  nTpcTrkMin);
-    const bool isInPtCut   = (trk_pt      >  ptTrkMin);
-    const bool isInQualCut = (trk_quality <  qualTrkMax);
-    const bool isGoodTrk   = (isInZVtxCut && isInInttCut && isInMVtxCut && isInTpcCut && isInPtCut && isInQualCut);
-    if (!isGoodTrk) continue;
+    const double ptFrac  = ptTrk / gptTrk;
+    const double ptDelta = deltaTrk / ptTrk;
 
     // apply delta-pt cuts
     const bool isNormalTrk = ((ptFrac > normRange[0]) && (ptFrac < normRange[1]));
+    uint64_t   passSigs    = 0;
+    if (doBootstrap) boot.SetUnit((uint64_t) eventTrk);
     for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
 
       // get bounds
-      const float ptDeltaMin = fMuLoProj[iSig] -> Eval(trk_pt);
-      const float ptDeltaMax = fMuHiProj[iSig] -> Eval(trk_pt);
+      const float ptDeltaMin = doBandTables ? tabMuLo[iSig].Eval(ptTrk) : fMuLoProj[iSig] -> Eval(ptTrk);
+      const float ptDeltaMax = doBandTables ? tabMuHi[iSig].Eval(ptTrk) : fMuHiProj[iSig] -> Eval(ptTrk);
 
       const bool isInDeltaPtSigma = ((ptDelta >= ptDeltaMin) && (ptDelta <= ptDeltaMax));
       if (isInDeltaPtSigma) {
+        passSigs |= (1ULL << iSig);
 
-        // fill histograms
-        hPtDeltaSig[iSig]        -> Fill(ptDelta);
-        hPtTrackSig[iSig]        -> Fill(trk_pt);
-        hPtFracSig[iSig]         -> Fill(ptFrac);
-        hPtTrkTruSig[iSig]       -> Fill(trk_gpt);
-        hPtDeltaVsFracSig[iSig]  -> Fill(ptFrac,  ptDelta);
-        hPtDeltaVsTrueSig[iSig]  -> Fill(trk_gpt, ptDelta);
-        hPtDeltaVsTrackSig[iSig] -> Fill(trk_pt,  ptDelta);
-        hPtTrueVsTrackSig[iSig]  -> Fill(trk_pt,  trk_gpt);
-
-        // increment counters
+        // increment counters (& their bootstrap replicas)
         if (isNormalTrk) {
           ++nNormSig[iSig];
         } else {
           ++nWeirdSig[iSig];
         }
+        if (doBootstrap) boot.Add(GetBootCounter(isNormalTrk ? Boot::BNormSig : Boot::BWeirdSig, iSig));
       }
     }  // end delta-pt cut
-  }  // end 1st track loop
+
+    // bin discriminating variables: the n-sigma score
+    // is measured with respect to the 1st sigma band
+    if (doRocSurface) {
+      double score = 0.;
+      if (nSigCuts > 0) {
+        const double bandLo = doBandTables ? tabMuLo[0].Eval(ptTrk) : fMuLoProj[0] -> Eval(ptTrk);
+        const double bandHi = doBandTables ? tabMuHi[0].Eval(ptTrk) : fMuHiProj[0] -> Eval(ptTrk);
+        if (bandHi > bandLo) score = (2. * ptDeltaSig[0] * (ptDelta - (0.5 * (bandHi + bandLo)))) / (bandHi - bandLo);
+      }
+
+      const double rocValues[Roc::NRoc] = {ptDelta, abs(score), qualTrk, ntpcTrk, nmvtxTrk};
+      if (isNormalTrk) {
+        cubeNorm.Fill(rocValues);
+      } else {
+        cubeWeird.Fill(rocValues);
+      }
+    }
+
+    // store decisions, and defer filling if needed
+    if (doTrackStore) trkStore.passSig[iTrk] = passSigs;
+    if (doDeferHists) continue;
+
+    // in buffered mode, fill when buffer is full
+    if (doFillBuffer) {
+      const double trkValues[Col::NCol] = {ptDelta, ptTrk, ptFrac, gptTrk};
+      buffer.Add(trkValues, passSigs);
+      if (buffer.IsFull()) buffer.Flush(vhPtSig, vhFillCols, pool);
+      continue;
+    }
+
+    // find bins once per track: every histogram shares these axes
+    const uint32_t iBinDelta        = axDelta.FindBin(ptDelta);
+    const uint32_t iBinTrack        = axPt.FindBin(ptTrk);
+    const uint32_t iBinFrac         = axFrac.FindBin(ptFrac);
+    const uint32_t iBinTrkTru       = axPt.FindBin(gptTrk);
+    const uint64_t iBinDeltaVsFrac  = vhPtSig[Hist::HDeltaVsFrac].GetBin(iBinFrac,   iBinDelta);
+    const uint64_t iBinDeltaVsTrue  = vhPtSig[Hist::HDeltaVsTrue].GetBin(iBinTrkTru, iBinDelta);
+    const uint64_t iBinDeltaVsTrack = vhPtSig[Hist::HDeltaVsTrack].GetBin(iBinTrack, iBinDelta);
+    const uint64_t iBinTrueVsTrack  = vhPtSig[Hist::HTrueVsTrack].GetBin(iBinTrack,  iBinTrkTru);
+
+    // fill passing cut variants
+    for (uint64_t mask = passSigs; mask != 0; mask &= (mask - 1)) {
+      const size_t iSig = __builtin_ctzll(mask);
+      vhPtSig[Hist::HDelta].Fill(iSig, iBinDelta);
+      vhPtSig[Hist::HTrack].Fill(iSig, iBinTrack);
+      vhPtSig[Hist::HFrac].Fill(iSig, iBinFrac);
+      vhPtSig[Hist::HTrkTru].Fill(iSig, iBinTrkTru);
+      vhPtSig[Hist::HDeltaVsFrac].Fill(iSig, iBinDeltaVsFrac);
+      vhPtSig[Hist::HDeltaVsTrue].Fill(iSig, iBinDeltaVsTrue);
+      vhPtSig[Hist::HDeltaVsTrack].Fill(iSig, iBinDeltaVsTrack);
+      vhPtSig[Hist::HTrueVsTrack].Fill(iSig, iBinTrueVsTrack);
+    }
+  }  // end 2nd track loop
+
+  // fill from store if deferred, then
+  // flush remaining buffered tracks
+  if (doDeferHists) {
+    FillHistsFromStore(vhPtSig, trkStore.passSig, 0, pool);
+  }
+  buffer.Flush(vhPtSig, vhFillCols, pool);
+
+  // export cut variants into output histograms
+  ExportSigmaCutHists();
 
   cout << "      Second loop over reco. tracks finished!" << endl;
   return;
@@ -176,19 +600,349 @@ void SDeltaPtCutStudy::ApplyPtDependentDeltaPtCuts() {
 
 
 
+void SDeltaPtCutStudy::FillHistsFromStore(vector<SVariantHist>& engines, const vector<uint64_t>& passMasks, const uint64_t passAll, const SFitPool& pool) {
+
+  // push stored tracks through a fill buffer
+  SFillBuffer buffer(axFillCols, nFillBuffer);
+  for (size_t iTrk = 0; iTrk < trkStore.GetSize(); iTrk++) {
+    const double trkValues[Col::NCol] = {
+      trkStore.GetPtDelta(iTrk),
+      trkStore.pt[iTrk],
+      trkStore.GetPtFrac(iTrk),
+      trkStore.gpt[iTrk]
+    };
+    buffer.Add(trkValues, passMasks[iTrk] | passAll);
+    if (buffer.IsFull()) buffer.Flush(engines, vhFillCols, pool);
+  }
+  buffer.Flush(engines, vhFillCols, pool);
+
+  cout << "        Filled histograms from " << trkStore.GetSize() << " stored tracks." << endl;
+  return;
+
+}  // end 'FillHistsFromStore(vector<SVariantHist>&, vector<uint64_t>&, uint64_t, SFitPool&)'
+
+
+
+size_t SDeltaPtCutStudy::GetBootCounter(const Boot set, const size_t index) const {
+
+  // counters are laid out as [norm. flat][weird flat][norm. sigma][weird sigma][truth]
+  size_t offset = 0;
+  switch (set) {
+    case Boot::BNormCut:
+      offset = 0;
+      break;
+    case Boot::BWeirdCut:
+      offset = nDPtCuts;
+      break;
+    case Boot::BNormSig:
+      offset = 2 * nDPtCuts;
+      break;
+    case Boot::BWeirdSig:
+      offset = (2 * nDPtCuts) + nSigCuts;
+      break;
+    case Boot::BTruth:
+      offset = (2 * nDPtCuts) + (2 * nSigCuts);
+      break;
+  }
+  return offset + index;
+
+}  // end 'GetBootCounter(Boot, size_t)'
+
+
+
+void SDeltaPtCutStudy::MatchTrackToTruth(const uint64_t variants) {
+
+  // tracks without a truth particle have no gtrackID
+  uint32_t iTru = STruthIndex::NEmpty;
+  if (!isnan(trk_gtrackID)) {
+    iTru = truIndex.Find(STruthIndex::MakeKey((uint32_t) trk_event, (int32_t) trk_gtrackID));
+  }
+
+  // count track in each cut variant it passes
+  const size_t nVar = nDPtCuts + 1;
+  for (uint64_t mask = variants; mask != 0; mask &= (mask - 1)) {
+    const size_t iVar = __builtin_ctzll(mask);
+    if (iTru == STruthIndex::NEmpty) {
+      ++nFakeTrk[iVar];
+    } else if (!truPrimary[iTru]) {
+      ++nSecondTrk[iVar];
+    } else {
+      ++nMatchTrk[iVar];
+      ++nTruMatch[(iTru * nVar) + iVar];
+    }
+  }
+  return;
+
+}  // end 'MatchTrackToTruth(uint64_t)'
+
+
+
+uint32_t SDeltaPtCutStudy::GetGeneralCutMask() const {
+
+  // set a bit for each general cut the current track fails
+  const bool isInZVtxCut = (abs(trk_vz) <  vzTrkMax);
+  const bool isInInttCut = (trk_nintt   >= nInttTrkMin);
+  const bool isInMVtxCut = (trk_nlmaps  >  nMVtxTrkMin);
+  const bool isInTpcCut  = (trk_ntpc    >  nTpcTrkMin);
+  const bool isInPtCut   = (trk_pt      >  ptTrkMin);
+  const bool isInQualCut = (trk_quality <  qualTrkMax);
+  const bool isInSecCut  = (!doSectorMask || !sectorMask.IsMasked(trk_phi));
+
+  uint32_t failCuts = 0;
+  if (!isInZVtxCut) failCuts |= (1U << Flow::FZVtx);
+  if (!isInInttCut) failCuts |= (1U << Flow::FIntt);
+  if (!isInMVtxCut) failCuts |= (1U << Flow::FMVtx);
+  if (!isInTpcCut)  failCuts |= (1U << Flow::FTpc);
+  if (!isInPtCut)   failCuts |= (1U << Flow::FPt);
+  if (!isInQualCut) failCuts |= (1U << Flow::FQual);
+  if (!isInSecCut)  failCuts |= bitSector;
+  return failCuts;
+
+}  // end 'GetGeneralCutMask()'
+
+
+
+TH1* SDeltaPtCutStudy::GetFlatCutHist(const size_t iHist, const size_t iCut) {
+
+  // no-cut histograms are in the last slot
+  const bool isNoCut = (iCut == nDPtCuts);
+
+  TH1* hist = NULL;
+  switch (iHist) {
+    case Hist::HDelta:
+      hist = isNoCut ? hPtDelta : hPtDeltaCut[iCut];
+      break;
+    case Hist::HTrack:
+      hist = isNoCut ? hPtTrack : hPtTrackCut[iCut];
+      break;
+    case Hist::HFrac:
+      hist = isNoCut ? hPtFrac : hPtFracCut[iCut];
+      break;
+    case Hist::HTrkTru:
+      hist = isNoCut ? hPtTrkTru : hPtTrkTruCut[iCut];
+      break;
+    case Hist::HDeltaVsFrac:
+      hist = isNoCut ? hPtDeltaVsFrac : hPtDeltaVsFracCut[iCut];
+      break;
+    case Hist::HDeltaVsTrue:
+      hist = isNoCut ? hPtDeltaVsTrue : hPtDeltaVsTrueCut[iCut];
+      break;
+    case Hist::HDeltaVsTrack:
+      hist = isNoCut ? hPtDeltaVsTrack : hPtDeltaVsTrackCut[iCut];
+      break;
+    case Hist::HTrueVsTrack:
+      hist = isNoCut ? hPtTrueVsTrack : hPtTrueVsTrackCut[iCut];
+      break;
+  }
+  return hist;
+
+}  // end 'GetFlatCutHist(size_t, size_t)'
+
+
+
+TH1* SDeltaPtCutStudy::GetSigmaCutHist(const size_t iHist, const size_t iSig) {
+
+  TH1* hist = NULL;
+  switch (iHist) {
+    case Hist::HDelta:
+      hist = hPtDeltaSig[iSig];
+      break;
+    case Hist::HTrack:
+      hist = hPtTrackSig[iSig];
+      break;
+    case Hist::HFrac:
+      hist = hPtFracSig[iSig];
+      break;
+    case Hist::HTrkTru:
+      hist = hPtTrkTruSig[iSig];
+      break;
+    case Hist::HDeltaVsFrac:
+      hist = hPtDeltaVsFracSig[iSig];
+      break;
+    case Hist::HDeltaVsTrue:
+      hist = hPtDeltaVsTrueSig[iSig];
+      break;
+    case Hist::HDeltaVsTrack:
+      hist = hPtDeltaVsTrackSig[iSig];
+      break;
+    case Hist::HTrueVsTrack:
+      hist = hPtTrueVsTrackSig[iSig];
+      break;
+  }
+  return hist;
+
+}  // end 'GetSigmaCutHist(size_t, size_t)'
+
+
+
+void SDeltaPtCutStudy::SetFlatCutHist(const size_t iHist, const size_t iCut, TH1* hist) {
+
+  // no-cut histograms are in the last slot
+  const bool isNoCut = (iCut == nDPtCuts);
+
+  switch (iHist) {
+    case Hist::HDelta:
+      (isNoCut ? hPtDelta : hPtDeltaCut[iCut]) = (TH1D*) hist;
+      break;
+    case Hist::HTrack:
+      (isNoCut ? hPtTrack : hPtTrackCut[iCut]) = (TH1D*) hist;
+      break;
+    case Hist::HFrac:
+      (isNoCut ? hPtFrac : hPtFracCut[iCut]) = (TH1D*) hist;
+      break;
+    case Hist::HTrkTru:
+      (isNoCut ? hPtTrkTru : hPtTrkTruCut[iCut]) = (TH1D*) hist;
+      break;
+    case Hist::HDeltaVsFrac:
+      (isNoCut ? hPtDeltaVsFrac : hPtDeltaVsFracCut[iCut]) = (TH2D*) hist;
+      break;
+    case Hist::HDeltaVsTrue:
+      (isNoCut ? hPtDeltaVsTrue : hPtDeltaVsTrueCut[iCut]) = (TH2D*) hist;
+      break;
+    case Hist::HDeltaVsTrack:
+      (isNoCut ? hPtDeltaVsTrack : hPtDeltaVsTrackCut[iCut]) = (TH2D*) hist;
+      break;
+    case Hist::HTrueVsTrack:
+      (isNoCut ? hPtTrueVsTrack : hPtTrueVsTrackCut[iCut]) = (TH2D*) hist;
+      break;
+  }
+  return;
+
+}  // end 'SetFlatCutHist(size_t, size_t, TH1*)'
+
+
+
+void SDeltaPtCutStudy::SetSigmaCutHist(const size_t iHist, const size_t iSig, TH1* hist) {
+
+  switch (iHist) {
+    case Hist::HDelta:
+      hPtDeltaSig[iSig] = (TH1D*) hist;
+      break;
+    case Hist::HTrack:
+      hPtTrackSig[iSig] = (TH1D*) hist;
+      break;
+    case Hist::HFrac:
+      hPtFracSig[iSig] = (TH1D*) hist;
+      break;
+    case Hist::HTrkTru:
+      hPtTrkTruSig[iSig] = (TH1D*) hist;
+      break;
+    case Hist::HDeltaVsFrac:
+      hPtDeltaVsFracSig[iSig] = (TH2D*) hist;
+      break;
+    case Hist::HDeltaVsTrue:
+      hPtDeltaVsTrueSig[iSig] = (TH2D*) hist;
+      break;
+    case Hist::HDeltaVsTrack:
+      hPtDeltaVsTrackSig[iSig] = (TH2D*) hist;
+      break;
+    case Hist::HTrueVsTrack:
+      hPtTrueVsTrackSig[iSig] = (TH2D*) hist;
+      break;
+  }
+  return;
+
+}  // end 'SetSigmaCutHist(size_t, size_t, TH1*)'
+
+
+
+TH1* SDeltaPtCutStudy::MakeCutHist(const TString& sName, const size_t iHist) {
+
+  // binning follows the columns the engine is filled with
+  const SVariantAxis& axX = axFillCols[vhFillCols[iHist].first];
+
+  TH1* hist = NULL;
+  if (vhFillCols[iHist].second < 0) {
+    hist = new TH1D(sName.Data(), "", axX.nBins, axX.xMin, axX.xMax);
+  } else {
+    const SVariantAxis& axY = axFillCols[vhFillCols[iHist].second];
+    hist = new TH2D(sName.Data(), "", axX.nBins, axX.xMin, axX.xMax, axY.nBins, axY.xMin, axY.xMax);
+  }
+  hist -> Sumw2();
+  return hist;
+
+}  // end 'MakeCutHist(TString&, size_t)'
+
+
+
+void SDeltaPtCutStudy::ExportFlatCutHists() {
+
+  // cut histograms are created here & each engine is released
+  // once exported, so an engine & all of its histograms are
+  // never held at once (no-cut histograms already exist)
+  fOutput -> cd();
+  for (size_t iHist = 0; iHist < Hist::NHist; iHist++) {
+    for (size_t iCut = 0; iCut <= nDPtCuts; iCut++) {
+      if (iCut < nDPtCuts) SetFlatCutHist(iHist, iCut, MakeCutHist(sFlatCutNames[iHist][iCut], iHist));
+      if (!vhPtCut.empty()) vhPtCut[iHist].Export(iCut, GetFlatCutHist(iHist, iCut));
+    }
+    if (!vhPtCut.empty()) vhPtCut[iHist] = SVariantHist();
+  }
+  vhPtCut.clear();
+  return;
+
+}  // end 'ExportFlatCutHists()'
+
+
+
+void SDeltaPtCutStudy::ExportSigmaCutHists() {
+
+  // same as for flat cuts (without engines, histograms stay empty)
+  fOutput -> cd();
+  for (size_t iHist = 0; iHist < Hist::NHist; iHist++) {
+    for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+      SetSigmaCutHist(iHist, iSig, MakeCutHist(sSigmaCutNames[iHist][iSig], iHist));
+      if (!vhPtSig.empty()) vhPtSig[iHist].Export(iSig, GetSigmaCutHist(iHist, iSig));
+    }
+    if (!vhPtSig.empty()) vhPtSig[iHist] = SVariantHist();
+  }
+  vhPtSig.clear();
+  return;
+
+}  // end 'ExportSigmaCutHists()'
+
+
+
 void SDeltaPtCutStudy::FillTruthHistograms() {
 
+  // with a complete truth index, particles are already in memory
+  // (not built when resuming at the 2nd loop, & cut short if the
+  // 1st pass was interrupted: fall back to the tuple then)
+  const bool hasFullIndex = (doTruthMatch && (truPt.size() == nTrus));
+  if (hasFullIndex) {
+    for (size_t iTru = 0; iTru < truPt.size(); iTru++) {
+      if (!truPrimary[iTru]) continue;
+      hPtTruth -> Fill(truPt[iTru]);
+      if (doBootstrap) {
+        boot.SetUnit(truEvent[iTru]);
+        boot.Add(GetBootCounter(Boot::BTruth, 0));
+      }
+    }
+    nProcTruth = truPt.size();
+    cout << "      Filled particle histograms from truth index." << endl;
+    return;
+  }
+
   // announce start of truth loop
   cout << "      Loop over particles:" << endl;
 
   // truth loop
   uint64_t nBytesTru = 0;
+  nProcTruth = nTrus;
   for (uint64_t iTru = 0; iTru < nTrus; iTru++) {
 
+    // stop cleanly if interrupted
+    if (isInterrupted) {
+      cout << "\n        Interrupted at particle " << iTru << "/" << nTrus << "! Stopping loop." << endl;
+      nProcTruth = iTru;
+      break;
+    }
+
     // grab entry
     const uint64_t bytesTru = ntTruth -> GetEntry(iTru);
     if (bytesTru < 0.) {
       cerr << "WARNING: something wrong with particle #" << iTru << "! Aborting loop!" << endl;
+      nProcTruth = iTru;
       break;
     }
     nBytesTru += bytesTru;
@@ -205,6 +959,10 @@ void SDeltaPtCutStudy::FillTruthHistograms() {
     const bool isPrimary = (tru_gprimary == 1);
     if (isPrimary) {
       hPtTruth -> Fill(tru_gpt);
+      if (doBootstrap) {
+        boot.SetUnit((uint64_t) tru_event);
+        boot.Add(GetBootCounter(Boot::BTruth, 0));
+      }
     }
   }  // end track loop
   cout << "      Loop over particles finished!" << endl;
@@ -229,14 +987,37 @@ void SDeltaPtCutStudy::CreateSigmaGraphs() {
     sFitProj[iProj].Append(sProjSuffix[iProj].Data());
   }
 
-  // project slices of delta-pt and get sigmas
+  // fits run concurrently if needed: histograms & functions
+  // are created serially, only the fits themselves are shared;
+  // parallel fits need Minuit2 (restored after) & are quiet,
+  // serial ones use the default minimizer & printout as is
+  const SFitPool                  pool(doParallelFits ? nFitThreads : 1);
+  const unique_ptr<SFitMinimizer> minimizer(doParallelFits ? new SFitMinimizer("Minuit2", "Migrad") : NULL);
+  const TString                   sFitOpt = doParallelFits ? "Q" : "";
+  if (doParallelFits) {
+    SFitPool::EnableThreadSafeFits();
+    cout << "      Running fits on " << pool.GetNThreads() << " threads." << endl;
+  }
+
+  // fit diagnostics are collected per run
+  fitRecords.clear();
+
+  // index delta-pt vs. pt once, so slices of
+  // any width can be read out without rescanning
+  psDeltaVsTrack.Build(hPtDeltaVsTrack -> GetArray(), axPt.nBins, axDelta.nBins);
+
+  // project slices of delta-pt and set up fits
   const uint32_t fWidFit = 2;
   const uint32_t fLinFit = 1;
+
+  vector<pair<uint32_t, uint32_t>> binsProj(nProj);
   for (size_t iProj = 0; iProj < nProj; iProj++) {
 
     // do projection
-    const uint32_t iBinProj = hPtDeltaVsTrack -> GetXaxis() -> FindBin(ptProj[iProj]);
-    hPtDeltaProj[iProj]   = hPtDeltaVsTrack -> ProjectionY(sPtProj[iProj], iBinProj, iBinProj, "");
+    const uint32_t iBinLo = hPtDeltaVsTrack -> GetXaxis() -> FindBin(ptProj[iProj] - (0.5 * ptProjWidth));
+    const uint32_t iBinHi = hPtDeltaVsTrack -> GetXaxis() -> FindBin(ptProj[iProj] + (0.5 * ptProjWidth));
+    hPtDeltaProj[iProj] = MakeSliceHist(sPtProj[iProj], iBinLo, iBinHi);
+    binsProj[iProj]     = make_pair(iBinLo, iBinHi);
 
     // get initial values for fit
     const float ampGuess = hPtDeltaProj[iProj] -> GetMaximum();
@@ -251,18 +1032,94 @@ void SDeltaPtCutStudy::CreateSigmaGraphs() {
     fPtDeltaProj[iProj] -> SetParameter(0, ampGuess);
     fPtDeltaProj[iProj] -> SetParameter(1, muGuess);
     fPtDeltaProj[iProj] -> SetParameter(2, sigGuess);
-    hPtDeltaProj[iProj] -> Fit(sFitProj[iProj].Data(), "R");
+  }  // end projection loop
 
-    // add values to arrays
-    muProj[iProj]  = fPtDeltaProj[iProj] -> GetParameter(1);
-    sigProj[iProj] = fPtDeltaProj[iProj] -> GetParameter(2);
-    for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
-      muHiProj[iSig][iProj] = muProj[iProj] + (ptDeltaSig[iSig] * sigProj[iProj]);
-      muLoProj[iSig][iProj] = muProj[iProj] - (ptDeltaSig[iSig] * sigProj[iProj]);
+  // fit projections with gaussians (with fast estimates,
+  // only done as a cross-check)
+  vector<SFitRecord> recProj(nProj);
+  if (!doFastSlices || doSliceCrossCheck) {
+    pool.Run(nProj, [&](const size_t iProj) {
+      recProj[iProj].kind  = SFitRecord::Kind::Slice;
+      recProj[iProj].index = iProj;
+      recProj[iProj].x     = ptProj[iProj];
+      recProj[iProj].Start();
+
+      const TFitResultPtr result = hPtDeltaProj[iProj] -> Fit(fPtDeltaProj[iProj], "RS" + sFitOpt);
+      recProj[iProj].Stop(result, fPtDeltaProj[iProj]);
+    });
+    fitRecords.insert(fitRecords.end(), recProj.begin(), recProj.end());
+  }
+
+  // add values to arrays
+  for (size_t iProj = 0; iProj < nProj; iProj++) {
+
+    // estimate directly from bin contents if needed
+    if (doFastSlices) {
+      SFitRecord record;
+      record.kind  = SFitRecord::Kind::Estimate;
+      record.index = iProj;
+      record.x     = ptProj[iProj];
+      record.Start();
+
+      const SGaussEstimate estimate = EstimateGauss(hPtDeltaProj[iProj] -> GetArray() + 1, 1, axDelta, deltaFitRange[0], deltaFitRange[1], nSliceSigTrunc, nSliceMaxIter);
+      if (!estimate.isGood) {
+        cerr << "WARNING: couldn't estimate mean and width of projection #" << iProj << "!" << endl;
+      }
+      record.Stop();
+      record.status = estimate.isGood ? 0 : 1;
+      record.nCalls = estimate.nIter;
+      fitRecords.push_back(record);
+
+      // compare against fit or store estimate in function
+      if (doSliceCrossCheck) {
+        cout << "      Projection #" << iProj << " (fast vs. fit):\n"
+             << "        mu    = " << estimate.mu    << " vs. " << fPtDeltaProj[iProj] -> GetParameter(1) << "\n"
+             << "        sigma = " << estimate.sigma << " vs. " << fPtDeltaProj[iProj] -> GetParameter(2)
+             << endl;
+      } else {
+        fPtDeltaProj[iProj] -> SetParameters(estimate.amp, estimate.mu, estimate.sigma);
+      }
+      muProj[iProj]  = estimate.mu;
+      sigProj[iProj] = estimate.sigma;
+    } else {
+      muProj[iProj]  = fPtDeltaProj[iProj] -> GetParameter(1);
+      sigProj[iProj] = fPtDeltaProj[iProj] -> GetParameter(2);
     }
   }  // end projection loop
   cout << "      Obtained delta-pt projections, fits, and sigmas." << endl;
 
+  // curves come from the chosen projections, or
+  // from every (group of) pt bin(s) if needed
+  if (doDenseSlices) GetDenseSlices(pool);
+
+  const vector<double>&                   ptCurve  = doDenseSlices ? ptDense   : ptProj;
+  const vector<double>&                   muCurve  = doDenseSlices ? muDense   : muProj;
+  const vector<double>&                   sigCurve = doDenseSlices ? sigDense  : sigProj;
+  const vector<pair<uint32_t, uint32_t>>& binCurve = doDenseSlices ? binsDense : binsProj;
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    muHiProj[iSig].resize(ptCurve.size());
+    muLoProj[iSig].resize(ptCurve.size());
+  }
+
+  // band points are either mu +- n * sigma, or the
+  // quantiles a gaussian would have at +- n * sigma
+  vector<double> slice(axDelta.nBins, 0.);
+  for (size_t iPoint = 0; iPoint < ptCurve.size(); iPoint++) {
+    if (doQuantileBands) {
+      psDeltaVsTrack.GetSliceY(binCurve[iPoint].first, binCurve[iPoint].second, slice.data());
+    }
+    for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+      if (doQuantileBands) {
+        const double fracLo = 0.5 * erfc(ptDeltaSig[iSig] / sqrt(2.));
+        muHiProj[iSig][iPoint] = GetSliceQuantile(slice.data(), axDelta, 1. - fracLo);
+        muLoProj[iSig][iPoint] = GetSliceQuantile(slice.data(), axDelta, fracLo);
+      } else {
+        muHiProj[iSig][iPoint] = muCurve[iPoint] + (ptDeltaSig[iSig] * sigCurve[iPoint]);
+        muLoProj[iSig][iPoint] = muCurve[iPoint] - (ptDeltaSig[iSig] * sigCurve[iPoint]);
+      }
+    }
+  }
+
   // sigma graph names
   TString sMuProj("gr");
   TString sSigProj("gr");
@@ -289,9 +1146,9 @@ void SDeltaPtCutStudy::CreateSigmaGraphs() {
   }
 
   // turn std::vectors into TVectors
-  TVectorD tvecPtProj(ptProj.size(), ptProj.data());
-  TVectorD tvecMuProj(muProj.size(), muProj.data());
-  TVectorD tvecSigProj(sigProj.size(), sigProj.data());
+  TVectorD tvecPtProj(ptCurve.size(), ptCurve.data());
+  TVectorD tvecMuProj(muCurve.size(), muCurve.data());
+  TVectorD tvecSigProj(sigCurve.size(), sigCurve.data());
 
   vector<TVectorD> tvecMuHiProj;
   vector<TVectorD> tvecMuLoProj;
@@ -315,9 +1172,11 @@ void SDeltaPtCutStudy::CreateSigmaGraphs() {
     grMuHiProj[iSig] -> SetName(sGrMuHiProj[iSig].Data());
     grMuLoProj[iSig] -> SetName(sGrMuLoProj[iSig].Data());
 
-    // create fit functions
-    fMuHiProj[iSig] = new TF1(sFnMuHiProj[iSig].Data(), "pol2", rPtRange[0], rPtRange[1]);
-    fMuLoProj[iSig] = new TF1(sFnMuLoProj[iSig].Data(), "pol2", rPtRange[0], rPtRange[1]);
+    // create fit functions (bands are mu +- n * sigma of
+    // the resolution model if fit unbinned)
+    const TString sBandForm = doUnbinnedFit ? SResolutionModel::BandFormula : "pol2";
+    fMuHiProj[iSig] = new TF1(sFnMuHiProj[iSig].Data(), sBandForm.Data(), rPtRange[0], rPtRange[1]);
+    fMuLoProj[iSig] = new TF1(sFnMuLoProj[iSig].Data(), sBandForm.Data(), rPtRange[0], rPtRange[1]);
     fMuHiProj[iSig] -> SetLineColor(fColSigFit[iSig]);
     fMuLoProj[iSig] -> SetLineColor(fColSigFit[iSig]);
     fMuHiProj[iSig] -> SetLineStyle(fLinFit);
@@ -331,33 +1190,282 @@ void SDeltaPtCutStudy::CreateSigmaGraphs() {
     fMuHiProj[iSig] -> SetParameter(2, sigHiGuess[2]);
     fMuLoProj[iSig] -> SetParameter(2, sigLoGuess[2]);
 
-    // do fitting
-    grMuHiProj[iSig] -> Fit(sFnMuHiProj[iSig].Data(), "", "", ptFitRange[0], ptFitRange[1]);
-    grMuLoProj[iSig] -> Fit(sFnMuLoProj[iSig].Data(), "", "", ptFitRange[0], ptFitRange[1]);
+  }
+
+  // do fitting (one job per band), or fit all
+  // bands at once to the tracks themselves
+  if (doUnbinnedFit) {
+    FitUnbinnedResolution();
+  } else {
+    vector<SFitRecord> recBand(2 * nSigCuts);
+    pool.Run(2 * nSigCuts, [&](const size_t iJob) {
+      const size_t iSig = iJob / 2;
+      const bool   isHi = ((iJob % 2) == 0);
+      recBand[iJob].kind  = SFitRecord::Kind::Band;
+      recBand[iJob].index = iSig;
+      recBand[iJob].x     = isHi ? ptDeltaSig[iSig] : (-1. * ptDeltaSig[iSig]);
+      recBand[iJob].Start();
+
+      TGraph*             graph    = isHi ? grMuHiProj[iSig] : grMuLoProj[iSig];
+      TF1*                function = isHi ? fMuHiProj[iSig]  : fMuLoProj[iSig];
+      const TFitResultPtr result   = graph -> Fit(function, "S" + sFitOpt, "", ptFitRange[0], ptFitRange[1]);
+      recBand[iJob].Stop(result, function);
+    });
+    fitRecords.insert(fitRecords.end(), recBand.begin(), recBand.end());
   }
 
   cout << "      Created and fit sigma graphs."  << endl;
+
+  // flag failed fits & the most expensive one
+  size_t nFailed  = 0;
+  size_t iSlowest = 0;
+  for (size_t iFit = 0; iFit < fitRecords.size(); iFit++) {
+    if (fitRecords[iFit].status != 0) {
+      cerr << "WARNING: fit (kind " << fitRecords[iFit].kind << ", index " << fitRecords[iFit].index << ", x = " << fitRecords[iFit].x << ") has status " << fitRecords[iFit].status << "!" << endl;
+      ++nFailed;
+    }
+    if (fitRecords[iFit].time > fitRecords[iSlowest].time) iSlowest = iFit;
+  }
+  if (!fitRecords.empty()) {
+    cout << "      Recorded " << fitRecords.size() << " fits (" << nFailed << " failed), slowest took " << fitRecords[iSlowest].time << " ms." << endl;
+  }
+
+  // tabulate bands if needed
+  if (doBandTables) BuildBandTables();
   return;
 
 }  // end 'CreateSigmaGraphs()'
 
 
 
+void SDeltaPtCutStudy::GetDenseSlices(const SFitPool& pool) {
+
+  const double widthX = (axPt.xMax - axPt.xMin) / axPt.nBins;
+
+  // group adjacent pt bins until there are enough entries,
+  // dropping groups that are still too sparse at max width
+  vector<pair<uint32_t, uint32_t>> groups;
+  double   sumGroup    = 0.;
+  uint32_t iGroupStart = 1;
+  for (uint32_t iBinX = 1; iBinX <= axPt.nBins; iBinX++) {
+    sumGroup += psDeltaVsTrack.Integral(iBinX, iBinX, 1, axDelta.nBins);
+
+    const bool isFull = (sumGroup >= nDenseMinEntries);
+    const bool isWide = ((iBinX - iGroupStart + 1) >= nDenseMaxGroup);
+    if (isFull || isWide) {
+      if (isFull) groups.push_back(make_pair(iGroupStart, iBinX));
+      sumGroup    = 0.;
+      iGroupStart = iBinX + 1;
+    }
+  }
+
+  // estimate mean & width of each group concurrently
+  const size_t           nGroups = groups.size();
+  vector<double>         ptGroup(nGroups, 0.);
+  vector<SGaussEstimate> estimates(nGroups);
+  vector<SFitRecord>     records(nGroups);
+  pool.Run(nGroups, [&](const size_t iGroup) {
+    records[iGroup].Start();
+
+    // entry-weighted pt of group
+    const uint32_t iStart = groups[iGroup].first;
+    const uint32_t iStop  = groups[iGroup].second;
+    double sumPt  = 0.;
+    double sumAll = 0.;
+    for (uint32_t iBinX = iStart; iBinX <= iStop; iBinX++) {
+      const double sumColumn = psDeltaVsTrack.Integral(iBinX, iBinX, 1, axDelta.nBins);
+      sumPt  += sumColumn * (axPt.xMin + ((iBinX - 0.5) * widthX));
+      sumAll += sumColumn;
+    }
+    ptGroup[iGroup] = (sumAll > 0.) ? (sumPt / sumAll) : (axPt.xMin + ((0.5 * (iStart + iStop - 1)) * widthX));
+
+    // read out slice & estimate
+    vector<double> slice(axDelta.nBins, 0.);
+    psDeltaVsTrack.GetSliceY(iStart, iStop, slice.data());
+    estimates[iGroup] = EstimateGauss(slice.data(), 1, axDelta, deltaFitRange[0], deltaFitRange[1], nSliceSigTrunc, nSliceMaxIter);
+    records[iGroup].Stop();
+  });
+
+  // record estimates
+  for (size_t iGroup = 0; iGroup < nGroups; iGroup++) {
+    records[iGroup].kind   = SFitRecord::Kind::Dense;
+    records[iGroup].index  = iGroup;
+    records[iGroup].x      = ptGroup[iGroup];
+    records[iGroup].status = estimates[iGroup].isGood ? 0 : 1;
+    records[iGroup].nCalls = estimates[iGroup].nIter;
+  }
+  fitRecords.insert(fitRecords.end(), records.begin(), records.end());
+
+  // collect good estimates in pt order
+  ptDense.clear();
+  binsDense.clear();
+  muDense.clear();
+  sigDense.clear();
+  for (size_t iGroup = 0; iGroup < nGroups; iGroup++) {
+    if (!estimates[iGroup].isGood) continue;
+    ptDense.push_back(ptGroup[iGroup]);
+    binsDense.push_back(groups[iGroup]);
+    muDense.push_back(estimates[iGroup].mu);
+    sigDense.push_back(estimates[iGroup].sigma);
+  }
+
+  cout << "      Obtained dense delta-pt slices: " << ptDense.size() << " of " << nGroups << " groups of pt bins kept." << endl;
+  return;
+
+}  // end 'GetDenseSlices(SFitPool&)'
+
+
+
+TH1D* SDeltaPtCutStudy::MakeSliceHist(const TString sName, const uint32_t iBinLo, const uint32_t iBinHi) {
+
+  // read out delta-pt in pt bins [iBinLo, iBinHi]
+  vector<double> slice(axDelta.nBins, 0.);
+  psDeltaVsTrack.GetSliceY(iBinLo, iBinHi, slice.data());
+
+  // fills are unweighted, so errors are sqrt(content)
+  TH1D* hist = new TH1D(sName.Data(), "", axDelta.nBins, axDelta.xMin, axDelta.xMax);
+  hist -> Sumw2();
+
+  double nEntries = 0.;
+  for (uint32_t iBin = 1; iBin <= axDelta.nBins; iBin++) {
+    hist -> SetBinContent(iBin, slice[iBin - 1]);
+    hist -> SetBinError(iBin, sqrt(slice[iBin - 1]));
+    nEntries += slice[iBin - 1];
+  }
+  hist -> SetEntries(nEntries);
+  return hist;
+
+}  // end 'MakeSliceHist(TString, uint32_t, uint32_t)'
+
+
+
+void SDeltaPtCutStudy::BuildBandTables() {
+
+  const SVariantAxis axTable((nBandTableBins > 0) ? nBandTableBins : axPt.nBins, axPt.xMin, axPt.xMax);
+
+  // tabulate band points of each sigma graph, or
+  // the bands themselves if they come from the model
+  tabMuHi.resize(nSigCuts);
+  tabMuLo.resize(nSigCuts);
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    if (doUnbinnedFit) {
+      vector<double> xTable(axTable.nBins);
+      vector<double> yHi(axTable.nBins);
+      vector<double> yLo(axTable.nBins);
+      for (uint32_t iBin = 0; iBin < axTable.nBins; iBin++) {
+        xTable[iBin] = axTable.xMin + ((iBin + 0.5) * ((axTable.xMax - axTable.xMin) / axTable.nBins));
+        yHi[iBin]    = fMuHiProj[iSig] -> Eval(xTable[iBin]);
+        yLo[iBin]    = fMuLoProj[iSig] -> Eval(xTable[iBin]);
+      }
+      tabMuHi[iSig].Build(xTable, yHi, axTable);
+      tabMuLo[iSig].Build(xTable, yLo, axTable);
+      continue;
+    }
+
+    const double*  xHi = grMuHiProj[iSig] -> GetX();
+    const double*  yHi = grMuHiProj[iSig] -> GetY();
+    const double*  xLo = grMuLoProj[iSig] -> GetX();
+    const double*  yLo = grMuLoProj[iSig] -> GetY();
+    const uint32_t nHi = grMuHiProj[iSig] -> GetN();
+    const uint32_t nLo = grMuLoProj[iSig] -> GetN();
+    tabMuHi[iSig].Build(vector<double>(xHi, xHi + nHi), vector<double>(yHi, yHi + nHi), axTable);
+    tabMuLo[iSig].Build(vector<double>(xLo, xLo + nLo), vector<double>(yLo, yLo + nLo), axTable);
+  }
+
+  cout << "      Tabulated sigma bands (" << axTable.nBins << " pt bins)." << endl;
+  return;
+
+}  // end 'BuildBandTables()'
+
+
+
+void SDeltaPtCutStudy::FitUnbinnedResolution() {
+
+  using namespace SResolutionModel;
+
+  // the likelihood only touches the store, so it
+  // always runs on all requested threads
+  const SFitPool pool(nFitThreads);
+  SResolutionFit fit(trkStore.pt, trkStore.deltapt, ptFitRange[0], ptFitRange[1], deltaFitRange[0], deltaFitRange[1]);
+
+  // seed with average projection mean & width
+  double muSeed  = 0.;
+  double sigSeed = 0.;
+  for (size_t iProj = 0; iProj < nProj; iProj++) {
+    muSeed  += muProj[iProj] / nProj;
+    sigSeed += sigProj[iProj] / nProj;
+  }
+  parUnbinned.fill(0.);
+  errUnbinned.fill(0.);
+  parUnbinned[Mu0]      = muSeed;
+  parUnbinned[SigConst] = (sigSeed > 0.) ? sigSeed : (0.1 * (deltaFitRange[1] - deltaFitRange[0]));
+  parUnbinned[FracTail] = 0.01;
+
+  SFitRecord record;
+  record.kind  = SFitRecord::Kind::Unbinned;
+  record.Start();
+
+  const bool isGood = fit.Fit(parUnbinned, errUnbinned, pool);
+  if (!isGood) {
+    cerr << "WARNING: unbinned resolution fit didn't converge! Bands may be unreliable." << endl;
+  }
+  record.Stop();
+  record.status = isGood ? 0 : 1;
+  record.chi2   = fit.GetMinNLL();
+  record.ndf    = fit.GetNTracks() - NPar;
+  record.nCalls = fit.GetNCalls();
+  record.parErr.assign(errUnbinned.begin(), errUnbinned.end());
+  fitRecords.push_back(record);
+
+  // bands are mu +- n * sigma of the fitted model
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    for (size_t iPar = 0; iPar < NBandPar; iPar++) {
+      fMuHiProj[iSig] -> SetParName(iPar, BandParNames[iPar]);
+      fMuLoProj[iSig] -> SetParName(iPar, BandParNames[iPar]);
+    }
+    for (size_t iPar = 0; iPar < NPar; iPar++) {
+      fMuHiProj[iSig] -> SetParameter(iPar, parUnbinned[iPar]);
+      fMuLoProj[iSig] -> SetParameter(iPar, parUnbinned[iPar]);
+      fMuHiProj[iSig] -> SetParError(iPar, errUnbinned[iPar]);
+      fMuLoProj[iSig] -> SetParError(iPar, errUnbinned[iPar]);
+    }
+    fMuHiProj[iSig] -> FixParameter(BandNSig, ptDeltaSig[iSig]);
+    fMuLoProj[iSig] -> FixParameter(BandNSig, -1. * ptDeltaSig[iSig]);
+  }
+
+  cout << "      Fit resolution unbinned to " << fit.GetNTracks() << " tracks on " << pool.GetNThreads() << " threads (" << fit.GetNCalls() << " calls):\n"
+       << "        mu(pt)    = " << parUnbinned[Mu0] << " + " << parUnbinned[Mu1] << " * pt + " << parUnbinned[Mu2] << " * pt^2\n"
+       << "        sigma(pt) = sqrt(" << parUnbinned[SigConst] << "^2 + (" << parUnbinned[SigSlope] << " * pt)^2)\n"
+       << "        tail      = " << parUnbinned[FracTail] << ", -ln(L) = " << fit.GetMinNLL()
+       << endl;
+  return;
+
+}  // end 'FitUnbinnedResolution()'
+
+
+
 void SDeltaPtCutStudy::CalculateRejectionFactors() {
 
   // for graph names
   const TString sRejCutBase = "Reject_flatDPtCut";
   const TString sRejSigBase = "Reject_sigmaCut";
 
-  // calculate flat delta-pt rejection factors
+  // calculate flat delta-pt rejection factors: with no
+  // weird tracks left, quote the lower limit nNorm / 1
+  bool isRejLimit = false;
   for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
-    rejCut[iCut] = (double) nNormCut[iCut] / (double) nWeirdCut[iCut];
+    rejCut[iCut] = (double) nNormCut[iCut] / (double) max(nWeirdCut[iCut], (uint64_t) 1);
+    if (nWeirdCut[iCut] == 0) isRejLimit = true;
   }
   cout << "      Calculated flat delta-pt rejection factors." << endl;
 
   // calculate pt-dependent delta-pt rejection factors
   for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
-    rejSig[iSig] = (double) nNormSig[iSig] / (double) nWeirdSig[iSig];
+    rejSig[iSig] = (double) nNormSig[iSig] / (double) max(nWeirdSig[iSig], (uint64_t) 1);
+    if (nWeirdSig[iSig] == 0) isRejLimit = true;
+  }
+  if (isRejLimit) {
+    cerr << "WARNING: some cuts leave no weird tracks! Their rejection factors are lower limits (nNorm / 1)." << endl;
   }
   cout << "      Calculated pt-depdendent delta-pt rejection factors\n"
        << "      Rejection factors:\n"
@@ -400,6 +1508,392 @@ void SDeltaPtCutStudy::CalculateRejectionFactors() {
 
 
 
+void SDeltaPtCutStudy::CalculateCutFlow() {
+
+  // counts only come from the 1st track loop
+  const uint64_t nFlowTrks = cutFlow.GetNTotal();
+  if (nFlowTrks == 0) {
+    cerr << "WARNING: no tracks were counted in the cut flow! Skipping cut-flow output." << endl;
+    return;
+  }
+
+  // make output histograms
+  hCutFlow        = cutFlow.MakeFlowHist("hCutFlow");
+  hCutNMinusOne   = cutFlow.MakeNMinusOneHist("hCutNMinusOne");
+  hCutMasks       = cutFlow.MakeMaskHist("hCutFailMasks");
+  hCutCorrelation = cutFlow.MakeCorrelationHist("hCutFailCorrelation");
+
+  // announce cut flow
+  const size_t nFlowCuts = cutFlow.GetNCuts();
+  cout << "      Cut flow (" << nFlowTrks << " tracks):\n"
+       << "        cut        sequential   eff.     alone        eff.     N-1"
+       << endl;
+  for (size_t iCut = 0; iCut < nFlowCuts; iCut++) {
+    const uint64_t nSeq   = cutFlow.GetNPassFirst(iCut + 1);
+    const uint64_t nAlone = cutFlow.GetNPass(iCut);
+    cout << "        " << setw(10) << left << cutFlow.GetName(iCut).Data() << right
+         << " " << setw(12) << nSeq   << " " << setw(8) << fixed << setprecision(4) << (double) nSeq / (double) nFlowTrks
+         << " " << setw(12) << nAlone << " " << setw(8) << (double) nAlone / (double) nFlowTrks
+         << " " << setw(12) << cutFlow.GetNMinusOne(iCut)
+         << defaultfloat << endl;
+  }
+
+  // announce correlations of failing each cut
+  cout << "      Correlation of failing cuts:\n        " << setw(10) << "";
+  for (size_t iCut = 0; iCut < nFlowCuts; iCut++) {
+    cout << " " << setw(8) << cutFlow.GetName(iCut).Data();
+  }
+  cout << endl;
+  for (size_t iCut = 0; iCut < nFlowCuts; iCut++) {
+    cout << "        " << setw(10) << left << cutFlow.GetName(iCut).Data() << right;
+    for (size_t jCut = 0; jCut < nFlowCuts; jCut++) {
+      cout << " " << setw(8) << fixed << setprecision(3) << cutFlow.GetCorrelation(iCut, jCut);
+    }
+    cout << defaultfloat << endl;
+  }
+  return;
+
+}  // end 'CalculateCutFlow()'
+
+
+
+void SDeltaPtCutStudy::CalculateSectorMask() {
+
+  // counts only come from the 1st track loop
+  const double nNoMask   = hPtDeltaNoMask -> GetEntries();
+  const double nWithMask = hPtDeltaWithMask -> GetEntries();
+  if (nNoMask == 0.) {
+    cerr << "WARNING: no tracks were counted for the sector mask! Skipping sector mask comparison." << endl;
+    return;
+  }
+
+  // delta-pt resolution with & without mask
+  const SGaussEstimate resNoMask   = EstimateGauss(hPtDeltaNoMask -> GetArray() + 1,   1, axDelta, deltaFitRange[0], deltaFitRange[1], nSliceSigTrunc, nSliceMaxIter);
+  const SGaussEstimate resWithMask = EstimateGauss(hPtDeltaWithMask -> GetArray() + 1, 1, axDelta, deltaFitRange[0], deltaFitRange[1], nSliceSigTrunc, nSliceMaxIter);
+  if (!resNoMask.isGood || !resWithMask.isGood) {
+    cerr << "WARNING: delta-pt resolution estimate with or without sector mask didn't converge!" << endl;
+  }
+
+  // flat delta-pt rejection factors without mask (with
+  // mask they're the nominal ones, i.e. rejCut)
+  vector<double> rejNoMask(nDPtCuts, 0.);
+  for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
+    rejNoMask[iCut] = (double) nNormNoMask[iCut] / (double) max(nWeirdNoMask[iCut], (uint64_t) 1);
+  }
+  grRejNoMask = new TGraph(nDPtCuts, ptDeltaMax.data(), rejNoMask.data());
+  grRejNoMask -> SetName("grRejectNoMask_flatDPtCut");
+
+  // announce results
+  cout << "      Sector mask (width = " << sectorMask.GetWidth() << ", " << nWithMask << "/" << nNoMask << " = " << (nWithMask / nNoMask) << " of tracks kept):\n"
+       << "        delta-pt/pt (mean, sigma) without mask = (" << resNoMask.mu << ", " << resNoMask.sigma << ")\n"
+       << "        delta-pt/pt (mean, sigma) with mask    = (" << resWithMask.mu << ", " << resWithMask.sigma << ")"
+       << endl;
+  for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
+    cout << "        delta-pt/pt < " << ptDeltaMax[iCut] << ": rejection without mask = " << rejNoMask[iCut] << ", with mask = " << rejCut[iCut]
+         << " (n(Norm, Weird) = (" << nNormNoMask[iCut] << ", " << nWeirdNoMask[iCut] << ") vs. (" << nNormCut[iCut] << ", " << nWeirdCut[iCut] << "))"
+         << endl;
+  }
+  return;
+
+}  // end 'CalculateSectorMask()'
+
+
+
+void SDeltaPtCutStudy::GroupTracksByParticle() {
+
+  // store is turned off if the 1st loop was skipped
+  if (!doTrackStore) {
+    cerr << "WARNING: no track store to group! Skipping track grouping." << endl;
+    return;
+  }
+  trkGroups.Build(trkStore.event, trkStore.gtrackID);
+
+  // tracks per particle (no cut)
+  const uint32_t nMultBins = 10;
+  hTrksPerParticle = new TH1D("hTrksPerParticle", "", nMultBins, 0.5, nMultBins + 0.5);
+  for (size_t iGroup = 0; iGroup < trkGroups.GetNGroups(); iGroup++) {
+    hTrksPerParticle -> Fill(min(trkGroups.GetGroupSize(iGroup), (size_t) nMultBins));
+  }
+
+  // origin of weird tracks (x) in each cut variant (y)
+  const size_t nVar = nDPtCuts + 1;
+  hWeirdOrigin = new TH2D("hWeirdOrigin", "", Origin::NOrigin, 0., Origin::NOrigin, nVar, 0., nVar);
+  hWeirdOrigin -> GetXaxis() -> SetBinLabel(Origin::OGhost + 1,       "ghost");
+  hWeirdOrigin -> GetXaxis() -> SetBinLabel(Origin::ODuplicate + 1,   "duplicate");
+  hWeirdOrigin -> GetXaxis() -> SetBinLabel(Origin::OSplit + 1,       "split");
+  hWeirdOrigin -> GetXaxis() -> SetBinLabel(Origin::OMismeasured + 1, "mismeasured");
+  for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
+    hWeirdOrigin -> GetYaxis() -> SetBinLabel(iCut + 1, sDPtSuffix[iCut].Data());
+  }
+  hWeirdOrigin -> GetYaxis() -> SetBinLabel(nVar, "no cut");
+
+  // a weird track is a ghost if it has no particle; else within
+  // a variant it is mismeasured if it's its particle's only track,
+  // a duplicate if its particle also has a normal track, & split
+  // if all of its particle's tracks are weird
+  vector<uint32_t> nTrkVar(nVar);
+  vector<uint32_t> nNormVar(nVar);
+  auto isNormal = [&](const size_t iTrk) {
+    const double ptFrac = trkStore.GetPtFrac(iTrk);
+    return ((ptFrac > normRange[0]) && (ptFrac < normRange[1]));
+  };  // end 'isNormal(size_t)'
+
+  for (size_t iTrk = 0; iTrk < trkStore.GetSize(); iTrk++) {
+    if (trkGroups.IsGrouped(iTrk) || isNormal(iTrk)) continue;
+    for (uint64_t mask = trkStore.passCut[iTrk] | (1ULL << nDPtCuts); mask != 0; mask &= (mask - 1)) {
+      hWeirdOrigin -> Fill(Origin::OGhost, __builtin_ctzll(mask));
+    }
+  }
+  for (size_t iGroup = 0; iGroup < trkGroups.GetNGroups(); iGroup++) {
+    const size_t    nMembers = trkGroups.GetGroupSize(iGroup);
+    const uint32_t* members  = trkGroups.GetMembers(iGroup);
+
+    // tally group within each variant
+    fill(nTrkVar.begin(), nTrkVar.end(), 0);
+    fill(nNormVar.begin(), nNormVar.end(), 0);
+    for (size_t iMember = 0; iMember < nMembers; iMember++) {
+      const size_t iTrk      = members[iMember];
+      const bool   isNormTrk = isNormal(iTrk);
+      for (uint64_t mask = trkStore.passCut[iTrk] | (1ULL << nDPtCuts); mask != 0; mask &= (mask - 1)) {
+        const size_t iVar = __builtin_ctzll(mask);
+        ++nTrkVar[iVar];
+        if (isNormTrk) ++nNormVar[iVar];
+      }
+    }
+
+    // classify weird members
+    for (size_t iMember = 0; iMember < nMembers; iMember++) {
+      const size_t iTrk = members[iMember];
+      if (isNormal(iTrk)) continue;
+      for (uint64_t mask = trkStore.passCut[iTrk] | (1ULL << nDPtCuts); mask != 0; mask &= (mask - 1)) {
+        const size_t iVar = __builtin_ctzll(mask);
+        if (nTrkVar[iVar] == 1) {
+          hWeirdOrigin -> Fill(Origin::OMismeasured, iVar);
+        } else if (nNormVar[iVar] > 0) {
+          hWeirdOrigin -> Fill(Origin::ODuplicate, iVar);
+        } else {
+          hWeirdOrigin -> Fill(Origin::OSplit, iVar);
+        }
+      }
+    }
+  }
+
+  // announce results
+  cout << "      Grouped " << trkStore.GetSize() << " stored tracks into " << trkGroups.GetNGroups() << " particles:" << endl;
+  for (size_t iVar = 0; iVar < nVar; iVar++) {
+    cout << "        " << hWeirdOrigin -> GetYaxis() -> GetBinLabel(iVar + 1) << ": weird tracks (ghost, duplicate, split, mismeasured) = (";
+    for (size_t iOrigin = 0; iOrigin < Origin::NOrigin; iOrigin++) {
+      cout << hWeirdOrigin -> GetBinContent(iOrigin + 1, iVar + 1) << ((iOrigin + 1 < Origin::NOrigin) ? ", " : ")");
+    }
+    cout << endl;
+  }
+  return;
+
+}  // end 'GroupTracksByParticle()'
+
+
+
+void SDeltaPtCutStudy::CalculateRocSurface() {
+
+  // for output names
+  const TString sRocTree("tRocSurface");
+  const TString sPareto("grParetoFront");
+
+  // index cubes so any box of bins is a constant-time lookup
+  cubeNorm.BuildIndex();
+  cubeWeird.BuildIndex();
+
+  // full ranges & totals
+  uint32_t binLo[Roc::NRoc];
+  uint32_t binHi[Roc::NRoc];
+  uint32_t nCuts[Roc::NRoc];
+  size_t   nPoints = 1;
+  for (size_t iRoc = 0; iRoc < Roc::NRoc; iRoc++) {
+    binLo[iRoc] = 0;
+    binHi[iRoc] = cubeNorm.GetAxis(iRoc).nBins + 1;
+    nCuts[iRoc] = cubeNorm.GetAxis(iRoc).nBins;
+    nPoints    *= nCuts[iRoc];
+  }
+  const double nNormAll = cubeNorm.Integral(binLo, binHi);
+
+  // ptDelta, score, & quality are kept below a bin's upper
+  // edge, hit counts at or above a bin's lower edge
+  const bool isLowerCut[Roc::NRoc] = {false, false, false, true, true};
+
+  vector<double>                   effRoc(nPoints, 0.);
+  vector<double>                   rejRoc(nPoints, 0.);
+  vector<double>                   nNormRoc(nPoints, 0.);
+  vector<double>                   nWeirdRoc(nPoints, 0.);
+  vector<array<double, Roc::NRoc>> cutRoc(nPoints);
+  for (size_t iPoint = 0; iPoint < nPoints; iPoint++) {
+
+    // box of this cut combination
+    size_t iRest = iPoint;
+    for (size_t iRoc = 0; iRoc < Roc::NRoc; iRoc++) {
+      const SVariantAxis& axis  = cubeNorm.GetAxis(iRoc);
+      const uint32_t      iBin  = (iRest % nCuts[iRoc]) + 1;
+      const double        width = (axis.xMax - axis.xMin) / axis.nBins;
+      iRest /= nCuts[iRoc];
+      if (isLowerCut[iRoc]) {
+        binLo[iRoc]          = iBin;
+        binHi[iRoc]          = axis.nBins + 1;
+        cutRoc[iPoint][iRoc] = axis.xMin + ((iBin - 1) * width);
+      } else {
+        binLo[iRoc]          = 0;
+        binHi[iRoc]          = iBin;
+        cutRoc[iPoint][iRoc] = axis.xMin + (iBin * width);
+      }
+    }
+
+    // rejection is a lower bound (nNorm) if no weird tracks survive
+    nNormRoc[iPoint]  = cubeNorm.Integral(binLo, binHi);
+    nWeirdRoc[iPoint] = cubeWeird.Integral(binLo, binHi);
+    effRoc[iPoint]    = (nNormAll > 0.) ? (nNormRoc[iPoint] / nNormAll) : 0.;
+    rejRoc[iPoint]    = nNormRoc[iPoint] / max(nWeirdRoc[iPoint], 1.);
+  }
+
+  // find pareto front
+  const vector<size_t> front = GetParetoFront(effRoc, rejRoc);
+  vector<bool>         isOnFront(nPoints, false);
+  for (const size_t iPoint : front) {
+    isOnFront[iPoint] = true;
+  }
+
+  // tree addresses
+  double cutValue[Roc::NRoc];
+  double nNorm;
+  double nWeird;
+  double eff;
+  double rej;
+  bool   isPareto;
+
+  const TString sCutNames[Roc::NRoc] = {"deltaMax", "scoreMax", "qualMax", "nTpcMin", "nMVtxMin"};
+  tRocSurface = new TTree(sRocTree.Data(), "rejection vs. efficiency of box cuts");
+  for (size_t iRoc = 0; iRoc < Roc::NRoc; iRoc++) {
+    tRocSurface -> Branch(sCutNames[iRoc].Data(), &cutValue[iRoc], (sCutNames[iRoc] + "/D").Data());
+  }
+  tRocSurface -> Branch("nNorm",      &nNorm,    "nNorm/D");
+  tRocSurface -> Branch("nWeird",     &nWeird,   "nWeird/D");
+  tRocSurface -> Branch("efficiency", &eff,      "efficiency/D");
+  tRocSurface -> Branch("rejection",  &rej,      "rejection/D");
+  tRocSurface -> Branch("isPareto",   &isPareto, "isPareto/O");
+  for (size_t iPoint = 0; iPoint < nPoints; iPoint++) {
+    for (size_t iRoc = 0; iRoc < Roc::NRoc; iRoc++) {
+      cutValue[iRoc] = cutRoc[iPoint][iRoc];
+    }
+    nNorm    = nNormRoc[iPoint];
+    nWeird   = nWeirdRoc[iPoint];
+    eff      = effRoc[iPoint];
+    rej      = rejRoc[iPoint];
+    isPareto = isOnFront[iPoint];
+    tRocSurface -> Fill();
+  }
+  tRocSurface -> ResetBranchAddresses();
+
+  // pareto front as rejection vs. efficiency
+  grParetoFront = new TGraph(front.size());
+  grParetoFront -> SetName(sPareto.Data());
+  for (size_t iFront = 0; iFront < front.size(); iFront++) {
+    grParetoFront -> SetPoint(iFront, effRoc[front[iFront]], rejRoc[front[iFront]]);
+  }
+
+  cout << "      Calculated roc surface: " << nPoints << " cut combinations, " << front.size() << " on the pareto front." << endl;
+  return;
+
+}  // end 'CalculateRocSurface()'
+
+
+
+void SDeltaPtCutStudy::CalculateGeneralCutScan() {
+
+  // for output names
+  const TString sScanTree("tGeneralCutScan");
+  const TString sScanSpec("hPtTrkTruScan");
+  const TString sScanEff("hEffScan");
+
+  // counts per cell -> counts per grid point
+  cutScan.Accumulate();
+
+  // truth spectrum in binning of scan
+  const SVariantAxis& axSpec = cutScan.GetSpectrumAxis();
+  vector<double>      truth(axSpec.nBins + 2, 0.);
+  for (int iBin = 1; iBin <= hPtTruth -> GetNbinsX(); iBin++) {
+    truth[axSpec.FindBin(hPtTruth -> GetBinCenter(iBin))] += hPtTruth -> GetBinContent(iBin);
+  }
+  const double nTruth = hPtTruth -> Integral();
+
+  // tree addresses (last variant = no delta-pt cut)
+  const size_t   nVar = cutScan.GetNVariants();
+  double         cutValue[SCutScan::Cut::NCut];
+  vector<double> nNormScan(nVar);
+  vector<double> nWeirdScan(nVar);
+  vector<double> rejScan(nVar);
+  vector<double> effScan(nVar);
+  vector<int>    limScan(nVar);
+  vector<double>* pNormScan  = &nNormScan;
+  vector<double>* pWeirdScan = &nWeirdScan;
+  vector<double>* pRejScan   = &rejScan;
+  vector<double>* pEffScan   = &effScan;
+  vector<int>*    pLimScan   = &limScan;
+
+  const TString sCutNames[SCutScan::Cut::NCut] = {"nInttMin", "nMVtxMin", "nTpcMin", "qualMax", "vzMax", "ptMin"};
+  tCutScan = new TTree(sScanTree.Data(), "rejection & efficiency vs. general track cuts");
+  for (size_t iCut = 0; iCut < SCutScan::Cut::NCut; iCut++) {
+    tCutScan -> Branch(sCutNames[iCut].Data(), &cutValue[iCut], (sCutNames[iCut] + "/D").Data());
+  }
+  tCutScan -> Branch("nNorm",      &pNormScan);
+  tCutScan -> Branch("nWeird",     &pWeirdScan);
+  tCutScan -> Branch("rejection",  &pRejScan);
+  tCutScan -> Branch("efficiency", &pEffScan);
+  tCutScan -> Branch("isRejLimit", &pLimScan);
+
+  // spectra & efficiencies vs. grid point
+  const size_t nPoints = cutScan.GetNPoints();
+  hPtTrkTruScan = new TH2D(sScanSpec.Data(), "", nPoints, 0., nPoints, axSpec.nBins, axSpec.xMin, axSpec.xMax);
+  hEffScan      = new TH2D(sScanEff.Data(),  "", nPoints, 0., nPoints, axSpec.nBins, axSpec.xMin, axSpec.xMax);
+  hPtTrkTruScan -> Sumw2();
+  hEffScan      -> Sumw2();
+
+  size_t nRejLimit = 0;
+  for (size_t iPoint = 0; iPoint < nPoints; iPoint++) {
+    for (size_t iCut = 0; iCut < SCutScan::Cut::NCut; iCut++) {
+      cutValue[iCut] = cutScan.GetCutValue(iPoint, iCut);
+    }
+
+    // if no weird tracks are left, rejection is the lower limit nNorm / 1
+    for (size_t iVar = 0; iVar < nVar; iVar++) {
+      nNormScan[iVar]  = cutScan.GetNNorm(iPoint, iVar);
+      nWeirdScan[iVar] = cutScan.GetNWeird(iPoint, iVar);
+      rejScan[iVar]    = nNormScan[iVar] / max(nWeirdScan[iVar], 1.);
+      limScan[iVar]    = (nWeirdScan[iVar] > 0.) ? 0 : 1;
+      effScan[iVar]    = (nTruth > 0.) ? ((nNormScan[iVar] + nWeirdScan[iVar]) / nTruth) : 0.;
+      nRejLimit       += limScan[iVar];
+    }
+    tCutScan -> Fill();
+
+    // truth spectrum is treated as exact
+    const double* spectrum = cutScan.GetSpectrum(iPoint);
+    for (uint32_t iBin = 1; iBin <= axSpec.nBins; iBin++) {
+      hPtTrkTruScan -> SetBinContent(iPoint + 1, iBin, spectrum[iBin]);
+      hPtTrkTruScan -> SetBinError(iPoint + 1, iBin, sqrt(spectrum[iBin]));
+      if (truth[iBin] > 0.) {
+        hEffScan -> SetBinContent(iPoint + 1, iBin, spectrum[iBin] / truth[iBin]);
+        hEffScan -> SetBinError(iPoint + 1, iBin, sqrt(spectrum[iBin]) / truth[iBin]);
+      }
+    }
+  }
+  tCutScan -> ResetBranchAddresses();
+
+  if (nRejLimit > 0) {
+    cerr << "WARNING: " << nRejLimit << " cut scan entries leave no weird tracks! Their rejection factors are lower limits (nNorm / 1), flagged by 'isRejLimit'." << endl;
+  }
+  cout << "      Calculated rejection and efficiency at " << nPoints << " general cut grid points." << endl;
+  return;
+
+}  // end 'CalculateGeneralCutScan()'
+
+
+
 void SDeltaPtCutStudy::CalculateEfficiencies() {
 
   // for histogram names
@@ -437,17 +1931,18 @@ void SDeltaPtCutStudy::CalculateEfficiencies() {
     sEffSig[iSig].Append(sSigSuffix[iSig].Data());
   }
 
+  // without a full truth spectrum, histograms are left empty
   hEff = (TH1D*) hPtTruth -> Clone();
   hEff -> SetName(sEff.Data());
   hEff -> Reset("ICES");
-  hEff -> Divide(hPtTrkTru, hPtTruth, 1., 1.);
+  if (hasEfficiency) hEff -> Divide(hPtTrkTru, hPtTruth, 1., 1.);
 
   // calculate flat delta-pt cut efficiencies
   for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
     hEffCut[iCut] = (TH1D*) hPtTruth -> Clone();
     hEffCut[iCut] -> SetName(sEffCut[iCut].Data());
     hEffCut[iCut] -> Reset("ICES");
-    hEffCut[iCut] -> Divide(hPtTrkTruCut[iCut], hPtTruth, 1., 1.);
+    if (hasEfficiency) hEffCut[iCut] -> Divide(hPtTrkTruCut[iCut], hPtTruth, 1., 1.);
   }
 
   // calculate pt-dependent delta-pt cut efficiencies
@@ -455,12 +1950,160 @@ void SDeltaPtCutStudy::CalculateEfficiencies() {
     hEffSig[iSig] = (TH1D*) hPtTruth -> Clone();
     hEffSig[iSig] -> SetName(sEffSig[iSig].Data());
     hEffSig[iSig] -> Reset("ICES");
-    hEffSig[iSig] -> Divide(hPtTrkTruSig[iSig], hPtTruth, 1., 1.);
+    if (hasEfficiency) hEffSig[iSig] -> Divide(hPtTrkTruSig[iSig], hPtTruth, 1., 1.);
   }
 
-  cout << "      Calculated efficiencies." << endl;
+  if (hasEfficiency) {
+    cout << "      Calculated efficiencies." << endl;
+  } else {
+    cout << "      Left efficiencies empty (no full truth spectrum)." << endl;
+  }
   return;
 
 }  // end 'CalculateEfficiencies()'
 
+
+
+void SDeltaPtCutStudy::CalculateBootstrapIntervals() {
+
+  // no. of primaries (denominator of integrated efficiencies)
+  const double nTruth = hPtTruth -> Integral(0, hPtTruth -> GetNbinsX() + 1);
+  const size_t nReps  = boot.GetNReplicas();
+  cout << "      Bootstrap intervals (" << nReps << " replicas, level = " << bootLevel << "):" << endl;
+
+  // get central values & intervals of rejection & efficiency
+  // for a set of cuts, and make graphs of them vs. cut value
+  auto makeGraphs = [&](const Boot normSet, const Boot weirdSet, const vector<double>& xCut, const vector<uint64_t>& nNorm, const vector<uint64_t>& nWeird, const TString sBase, TGraphAsymmErrors*& grRej, TGraphAsymmErrors*& grEff) {
+
+    TString sRej("grRejectBoot");
+    TString sEff("grEffBoot");
+    sRej.Append(sBase.Data());
+    sEff.Append(sBase.Data());
+    grRej = new TGraphAsymmErrors(xCut.size());
+    grEff = new TGraphAsymmErrors(xCut.size());
+    grRej -> SetName(sRej.Data());
+    grEff -> SetName(sEff.Data());
+
+    vector<double> rejRep(nReps);
+    vector<double> effRep(nReps);
+    for (size_t iCut = 0; iCut < xCut.size(); iCut++) {
+      const size_t iNorm  = GetBootCounter(normSet, iCut);
+      const size_t iWeird = GetBootCounter(weirdSet, iCut);
+      for (size_t iRep = 0; iRep < nReps; iRep++) {
+        const double normRep  = boot.GetCount(iNorm, iRep);
+        const double weirdRep = boot.GetCount(iWeird, iRep);
+        const double truthRep = boot.GetCount(GetBootCounter(Boot::BTruth, 0), iRep);
+        rejRep[iRep] = normRep / max(weirdRep, 1.);
+        effRep[iRep] = (truthRep > 0.) ? (normRep + weirdRep) / truthRep : 0.;
+      }
+
+      const double               rej    = (double) nNorm[iCut] / (double) max(nWeird[iCut], (uint64_t) 1);
+      const double               eff    = (nTruth > 0.) ? (double) (nNorm[iCut] + nWeird[iCut]) / nTruth : 0.;
+      const pair<double, double> rejInt = SBootstrap::GetInterval(rejRep, bootLevel);
+      const pair<double, double> effInt = SBootstrap::GetInterval(effRep, bootLevel);
+      grRej -> SetPoint(iCut, xCut[iCut], rej);
+      grEff -> SetPoint(iCut, xCut[iCut], eff);
+      grRej -> SetPointError(iCut, 0., 0., max(rej - rejInt.first, 0.), max(rejInt.second - rej, 0.));
+      grEff -> SetPointError(iCut, 0., 0., max(eff - effInt.first, 0.), max(effInt.second - eff, 0.));
+      cout << "          cut = " << xCut[iCut]
+           << ": rejection = " << rej << " [" << rejInt.first << ", " << rejInt.second << "]"
+           << ", efficiency = " << eff << " [" << effInt.first << ", " << effInt.second << "]"
+           << endl;
+    }
+  };  // end 'makeGraphs(Boot, Boot, vector<double>&, vector<uint64_t>&, vector<uint64_t>&, TString, TGraphAsymmErrors*&, TGraphAsymmErrors*&)'
+
+  cout << "        Flat delta-pt cuts" << endl;
+  makeGraphs(Boot::BNormCut, Boot::BWeirdCut, ptDeltaMax, nNormCut, nWeirdCut, "_flatDPtCut", grRejCutBoot, grEffCutBoot);
+  cout << "        Pt-dependent delta-pt cuts" << endl;
+  makeGraphs(Boot::BNormSig, Boot::BWeirdSig, ptDeltaSig, nNormSig, nWeirdSig, "_sigmaCut", grRejSigBoot, grEffSigBoot);
+  return;
+
+}  // end 'CalculateBootstrapIntervals()'
+
+
+
+void SDeltaPtCutStudy::CalculateTruthMatching() {
+
+  // for histogram & graph names
+  const TString sEffBase  = "EffMatched";
+  const TString sDupBase  = "DuplicateRate_flatDPtCut";
+  const TString sFakeBase = "FakeRate_flatDPtCut";
+
+  // primaries with at least 1 (or more than 1) matched
+  // track, binned like the (possibly rebinned) truth spectrum
+  const size_t     nVar = nDPtCuts + 1;
+  vector<TH1D*>    hPtTruthMatch(nVar);
+  vector<uint64_t> nTruFound(nVar, 0);
+  vector<uint64_t> nTruDup(nVar, 0);
+  for (size_t iVar = 0; iVar < nVar; iVar++) {
+    hPtTruthMatch[iVar] = (TH1D*) hPtTruth -> Clone();
+    hPtTruthMatch[iVar] -> Reset("ICES");
+  }
+  for (size_t iTru = 0; iTru < truPt.size(); iTru++) {
+    if (!truPrimary[iTru]) continue;
+    for (size_t iVar = 0; iVar < nVar; iVar++) {
+      const uint16_t nMatch = nTruMatch[(iTru * nVar) + iVar];
+      if (nMatch > 0) {
+        hPtTruthMatch[iVar] -> Fill(truPt[iTru]);
+        ++nTruFound[iVar];
+      }
+      if (nMatch > 1) ++nTruDup[iVar];
+    }
+  }
+
+  // matched efficiencies
+  TString sEff("h");
+  sEff.Append(sEffBase.Data());
+  hEffMatch = hPtTruthMatch[nDPtCuts];
+  hEffMatch -> SetName(sEff.Data());
+  hEffMatch -> Divide(hPtTruthMatch[nDPtCuts], hPtTruth, 1., 1.);
+
+  hEffMatchCut.resize(nDPtCuts);
+  for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
+    TString sEffCut("h");
+    sEffCut.Append(sEffBase.Data());
+    sEffCut.Append(sDPtSuffix[iCut].Data());
+    hEffMatchCut[iCut] = hPtTruthMatch[iCut];
+    hEffMatchCut[iCut] -> SetName(sEffCut.Data());
+    hEffMatchCut[iCut] -> Divide(hPtTruthMatch[iCut], hPtTruth, 1., 1.);
+  }
+
+  // duplicate rate = fraction of found primaries with more than 1
+  // track, fake rate = fraction of tracks without a truth particle
+  const uint64_t nTruPrim = count(truPrimary.begin(), truPrimary.end(), 1);
+  vector<double> effVar(nVar, 0.);
+  vector<double> dupVar(nVar, 0.);
+  vector<double> fakeVar(nVar, 0.);
+  for (size_t iVar = 0; iVar < nVar; iVar++) {
+    const uint64_t nTrkVar = nMatchTrk[iVar] + nSecondTrk[iVar] + nFakeTrk[iVar];
+    effVar[iVar]  = (nTruPrim > 0)       ? (double) nTruFound[iVar] / (double) nTruPrim : 0.;
+    dupVar[iVar]  = (nTruFound[iVar] > 0) ? (double) nTruDup[iVar] / (double) nTruFound[iVar] : 0.;
+    fakeVar[iVar] = (nTrkVar > 0)         ? (double) nFakeTrk[iVar] / (double) nTrkVar : 0.;
+  }
+
+  TString sDup("gr");
+  TString sFake("gr");
+  sDup.Append(sDupBase.Data());
+  sFake.Append(sFakeBase.Data());
+  grDupRateCut  = new TGraph(nDPtCuts, ptDeltaMax.data(), dupVar.data());
+  grFakeRateCut = new TGraph(nDPtCuts, ptDeltaMax.data(), fakeVar.data());
+  grDupRateCut  -> SetName(sDup.Data());
+  grFakeRateCut -> SetName(sFake.Data());
+
+  // announce results
+  cout << "      Truth matching (" << nTruPrim << " primaries):" << endl;
+  for (size_t iVar = 0; iVar < nVar; iVar++) {
+    if (iVar == nDPtCuts) {
+      cout << "        no delta-pt cut:";
+    } else {
+      cout << "        delta-pt/pt < " << ptDeltaMax[iVar] << ":";
+    }
+    cout << " matched eff. = " << effVar[iVar] << ", duplicate rate = " << dupVar[iVar] << ", fake rate = " << fakeVar[iVar]
+         << " (n(match, 2ndary, fake) = (" << nMatchTrk[iVar] << ", " << nSecondTrk[iVar] << ", " << nFakeTrk[iVar] << "))"
+         << endl;
+  }
+  return;
+
+}  // end 'CalculateTruthMatching()'
+
 // end ------------------------------------------------------------------------
@@ -20,6 +20,9 @@
 
 using namespace std;
 
+// set when a SIGINT/SIGTERM is caught
+volatile sig_atomic_t SDeltaPtCutStudy::isInterrupted = 0;
+
 
 
 // ctor/dtor ------------------------------------------------------------------
@@ -55,6 +58,7 @@ void SDeltaPtCutStudy::Init() {
   // initialize internal vectors & input/output
   InitVectors();
   InitTuples();
+  InitCutExpression();
   InitHists();
   return;
 
@@ -67,26 +71,103 @@ void SDeltaPtCutStudy::Analyze() {
   // announce analysis
   cout << "    Analyzing..." << endl;
 
+  // stop loops cleanly on SIGINT/SIGTERM
+  InstallSignalHandlers();
+
   // grab no. of entries for tuple loops
   nTrks = ntTrack -> GetEntries();
   nTrus = ntTruth -> GetEntries();
   cout << "      Beginning tuple loops: " << nTrks << " reco. tracks and " << nTrus << " particles to process" << endl;
 
+  // pick up from last checkpoint if available
+  ReadCheckpoint();
+
+  // decide extra track cuts up front
+  if (doCutExpr) EvaluateCutExpression();
+
+  // index truth particles for matching (only
+  // needed if the 1st loop will be run)
+  if (doTruthMatch && (ckptStage != Stage::SSigma)) BuildTruthIndex();
+
   // do 1st loop over tracks to:
   //   (1) apply flat delta-pt cuts
   //   (2) get graphs for pt-dependent cuts
-  ApplyFlatDeltaPtCuts();
-  CreateSigmaGraphs();
+  //   (bands can be read from the calibration cache instead,
+  //   & tracks from the track store of an earlier output; the
+  //   cache is read 1st so the loop is only skipped if it worked)
+  const bool isCached = (IsInCalibrationCache() && ReadCalibrationCache());
+  if (ckptStage == Stage::SSigma) {
+    cerr << "WARNING: resuming at 2nd track loop, so general cut scan, truth matching, and sector mask comparison are skipped." << endl;
+    hasFlatLoop = false;
+    ExportFlatCutHists();
+    if (!isCached) {
+      CreateSigmaGraphs();
+      if (!isInterrupted) WriteCalibrationCache();
+    }
+    ReadCheckpointBands();
+  } else {
+    if (doRebuildHists) {
+      RebuildFlatDeltaPtCuts();
+    } else if (isCached && doSkipFlatOnHit) {
+      SkipFlatDeltaPtCuts();
+    } else {
+      ApplyFlatDeltaPtCuts();
+    }
+    if (!isCached) {
+      CreateSigmaGraphs();
+      if (!isInterrupted) WriteCalibrationCache();
+    }
+    if (!isInterrupted) WriteCheckpoint(Stage::SSigma, 0);
+  }
 
   // do 2nd loop over tracks to:
   //   (1) apply pt-dependent cuts
   //   (2) calculate rejection factors
-  ApplyPtDependentDeltaPtCuts();
+  //   (if interrupted before, its histograms are left empty)
+  if (isInterrupted) {
+    ExportSigmaCutHists();
+  } else if (doRebuildHists) {
+    RebuildPtDependentDeltaPtCuts();
+  } else {
+    ApplyPtDependentDeltaPtCuts();
+  }
+  if (doTrackGroups) GroupTracksByParticle();
   CalculateRejectionFactors();
-
-  // get truth info and efficiencies
+  CalculateCutFlow();
+  if (hasFlatLoop && doSectorMask) CalculateSectorMask();
+  if (doRocSurface) CalculateRocSurface();
+
+  // get truth info: the truth loop doesn't depend on the track
+  // loops, so it's still run if one of them was cut short (and
+  // is re-armed so another interrupt stops it cleanly)
+  const bool isTrackCut = isInterrupted;
+  if (isTrackCut) {
+    cerr << "WARNING: track loops were interrupted! Still running truth loop, interrupt again to stop it." << endl;
+    isInterrupted = 0;
+  }
   FillTruthHistograms();
+  if (isTrackCut) isInterrupted = 1;
+
+  // efficiencies need full passes over tracks and particles,
+  // so if any loop was interrupted they're skipped (& their
+  // histograms left empty)
+  hasEfficiency = !isInterrupted;
+  if (!hasEfficiency) {
+    cerr << "WARNING: analysis was interrupted! Skipping efficiencies, cut scan, bootstrap, and truth matching." << endl;
+  }
+  if (hasEfficiency && hasFlatLoop && doCutScan) CalculateGeneralCutScan();
   CalculateEfficiencies();
+  if (hasEfficiency && doBootstrap) CalculateBootstrapIntervals();
+  if (hasEfficiency && hasFlatLoop && doTruthMatch) CalculateTruthMatching();
+
+  // announce if results are partial
+  if (isInterrupted) {
+    cout << "      Analysis was interrupted! Results are partial:\n"
+         << "        1st track loop = " << nProcFlat  << "/" << nTrks << " tracks\n"
+         << "        2nd track loop = " << nProcSigma << " tracks\n"
+         << "        truth loop     = " << nProcTruth << "/" << nTrus << " particles"
+         << endl;
+  }
   return;
 
 }  // end Analyze()
@@ -104,7 +185,9 @@ void SDeltaPtCutStudy::End() {
 
   // save and close
   SaveOutput();
+  RemoveCheckpoint();
   CloseFiles();
+  RestoreSignalHandlers();
 
   // announce end
   cout << "  Done with delta-pt cut study!\n" << endl;
@@ -112,4 +195,49 @@ void SDeltaPtCutStudy::End() {
 
 }  // end End()
 
+
+
+// signal handling ------------------------------------------------------------
+
+void SDeltaPtCutStudy::CatchSignal(int sigNum) {
+
+  // 1st signal stops the loops, a 2nd one
+  // falls back to the default behavior
+  if (isInterrupted) {
+    std::signal(sigNum, SIG_DFL);
+    std::raise(sigNum);
+    return;
+  }
+  isInterrupted = 1;
+  return;
+
+}  // end 'CatchSignal(int)'
+
+
+
+void SDeltaPtCutStudy::InstallSignalHandlers() {
+
+  // clear any interrupt left over from an earlier run
+  isInterrupted = 0;
+  if (!doCatchSignals) return;
+
+  prevSigInt  = std::signal(SIGINT,  SDeltaPtCutStudy::CatchSignal);
+  prevSigTerm = std::signal(SIGTERM, SDeltaPtCutStudy::CatchSignal);
+  cout << "      Installed SIGINT/SIGTERM handlers." << endl;
+  return;
+
+}  // end 'InstallSignalHandlers()'
+
+
+
+void SDeltaPtCutStudy::RestoreSignalHandlers() {
+
+  if (!doCatchSignals) return;
+
+  std::signal(SIGINT,  prevSigInt);
+  std::signal(SIGTERM, prevSigTerm);
+  return;
+
+}  // end 'RestoreSignalHandlers()'
+
 // end ------------------------------------------------------------------------
@@ -15,6 +15,11 @@
 // standard c includes
 #include <array>
 #include <cmath>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <iomanip>
+#include <csignal>
 #include <vector>
 #include <cassert>
 #include <cstdlib>
@@ -28,14 +33,35 @@
 #include <TFile.h>
 #include <TLine.h>
 #include <TGraph.h>
+#include <TGraphAsymmErrors.h>
 #include <TError.h>
+#include <TNamed.h>
 #include <TString.h>
 #include <TNtuple.h>
+#include <TParameter.h>
 #include <TLegend.h>
 #include <TCanvas.h>
 #include <TVector.h>
+#include <TSystem.h>
 #include <TPaveText.h>
 #include <TDirectory.h>
+// user includes
+#include "SCutExpr.h"
+#include "SCutFlow.h"
+#include "SCutScan.h"
+#include "SCountCube.h"
+#include "SFitPool.h"
+#include "SFitRecord.h"
+#include "SBandTable.h"
+#include "SBootstrap.h"
+#include "SPrefixSum.h"
+#include "SGaussEstimate.h"
+#include "SResolutionFit.h"
+#include "SSectorMask.h"
+#include "STrackGroups.h"
+#include "STrackStore.h"
+#include "STruthIndex.h"
+#include "SVariantHist.h"
 
 using namespace std;
 
@@ -55,6 +81,75 @@ class SDeltaPtCutStudy {
     NTrkCuts = 6
   };
 
+  // cut-dependent histogram accessors
+  enum Hist {
+    HDelta,
+    HTrack,
+    HFrac,
+    HTrkTru,
+    HDeltaVsFrac,
+    HDeltaVsTrue,
+    HDeltaVsTrack,
+    HTrueVsTrack,
+    NHist
+  };
+
+  // fill buffer column accessors
+  enum Col {
+    CDelta,
+    CTrack,
+    CFrac,
+    CTrkTru,
+    NCol
+  };
+
+  // rejection-vs-efficiency cube dimensions
+  enum Roc {
+    RDelta,
+    RScore,
+    RQual,
+    RTpc,
+    RMVtx,
+    NRoc
+  };
+
+  // cut-flow bits of general cuts (sector mask &
+  // cut expression, if used, take the next bits)
+  enum Flow {
+    FZVtx,
+    FIntt,
+    FMVtx,
+    FTpc,
+    FPt,
+    FQual,
+    NFlow
+  };
+
+  // bootstrap counter sets
+  enum Boot {
+    BNormCut,
+    BWeirdCut,
+    BNormSig,
+    BWeirdSig,
+    BTruth
+  };
+
+  // origins of weird tracks
+  enum Origin {
+    OGhost,
+    ODuplicate,
+    OSplit,
+    OMismeasured,
+    NOrigin
+  };
+
+  // checkpoint stages (i.e. which loop was running)
+  enum Stage {
+    SNone,
+    SFlat,
+    SSigma
+  };
+
   public:
 
     // ctor/dtor [*.cc]
@@ -73,6 +168,7 @@ class SDeltaPtCutStudy {
     void SetSigmaFitGuesses(const array<float, Const::NPar> hiGuess, const array<float, Const::NPar> loGuess);
     void SetNormAndFitRanges(const pair<float, float> norm, const pair<float, float> ptFit, const pair<float, float> deltaFit); 
     void SetPlotRanges(const pair<float, float> ptRange, const pair<float, float> fracRange, const pair<float, float> deltaRange);
+    void SetHistBinning(const uint64_t nPt, const pair<float, float> ptRange, const uint64_t nFrac, const pair<float, float> fracRange, const uint64_t nDelta, const pair<float, float> deltaRange);
     void SetGeneralStyleParameters(const array<uint32_t, Const::NTypes> arrCol, const array<uint32_t, Const::NTypes> arrMar);
     void SetGeneralHistParameters(const uint32_t fill, const uint32_t line, const uint32_t width, const uint32_t font, const uint32_t align, const uint32_t center);
     void SetHistBaseNames(const TString sProj, const TString sDelta, const TString sTrue, const TString sReco, const TString sFrac, const TString sTrack);
@@ -81,27 +177,94 @@ class SDeltaPtCutStudy {
     void SetProjectionParameters(const vector<tuple<double, TString, uint32_t, uint32_t, uint32_t>> projParams);
     void SetFlatCutParameters(const vector<tuple<double, TString, uint32_t, uint32_t, bool>> flatParams);
     void SetPtDependCutParameters(const vector<tuple<double, TString, uint32_t, uint32_t, uint32_t, bool>> ptDependParams);
+    void SetFillBufferParameters(const bool doBuffer, const size_t nBuffer = 1024, const size_t nThreads = 1);
+    void SetTrackStoreParameters(const bool doStore, const bool doDefer = false, const bool doSave = true);
+    void SetRebuildParameters(const bool doRebuild, const TString sFile = "");
+    void SetCheckpointParameters(const bool doCheckpoint, const uint64_t nEntries, const double tSeconds = 0., const bool doResume = true, const TString sFile = "");
+    void SetSignalHandling(const bool doCatch);
+    void SetParallelFitParameters(const bool doParallel, const size_t nThreads = 0);
+    void SetSliceEstimatorParameters(const bool doFast, const bool doCrossCheck = false, const double nSigTrunc = 2., const size_t nMaxIter = 20);
+    void SetDenseSliceParameters(const bool doDense, const double minEntries = 100., const size_t nMaxGroup = 10);
+    void SetProjectionWidth(const double width);
+    void SetBandTableParameters(const bool doTable, const bool doQuantiles = false, const uint32_t nTableBins = 0);
+    void SetCalibrationCacheParameters(const bool doCache, const TString sFile = "SDeltaPtCutStudy.calib.root", const bool doSkipFlat = false);
+    void SetUnbinnedFitParameters(const bool doUnbinned);
+    void SetCutExpression(const TString sExpr);
+    void SetRocSurfaceParameters(const bool doRoc, const vector<tuple<uint32_t, double, double>> rocAxes = {});
+    void SetGeneralCutScanParameters(const bool doScan, const array<vector<double>, SCutScan::Cut::NCut> grids, const uint32_t nSpecBins = 100);
+    void SetBootstrapParameters(const bool doBoot, const uint32_t nReplicas = 100, const double level = 0.68, const uint64_t seed = 0);
+    void SetTruthMatchParameters(const bool doMatch);
+    void SetTrackGroupParameters(const bool doGroup);
+    void SetSectorMaskParameters(const bool doMask, const double width = 0.02, const vector<double> boundaries = {});
 
   private:
 
+    // signal handling [*.cc]
+    static void CatchSignal(int sigNum);
+    void        InstallSignalHandlers();
+    void        RestoreSignalHandlers();
+
     // io methods [*.io.h]
     void OpenFiles();
     void GetTuples();
     void SaveOutput();
     void CloseFiles();
+    void ReadTrackStore();
+    void WriteCheckpoint(const Stage stage, const uint64_t iEntry);
+    void ReadCheckpoint();
+    void ReadCheckpointBands();
+    void ReadCheckpointSigmaHists();
+    void WriteCutHists(const vector<SVariantHist>& engines, const vector<vector<TString>>& sNames);
+    bool IsCheckpointDue(const uint64_t iEntry);
+    void RemoveCheckpoint();
+    TString GetCheckpointKey();
+    bool IsInCalibrationCache();
+    bool ReadCalibrationCache();
+    void WriteCalibrationCache();
+    TString GetCalibrationKey();
+    TString HashConfig(const TString& sPrefix, const string& config);
 
     // system methods [*.sys.h]
     void InitVectors();
     void InitTuples();
+    void InitCutExpression();
     void InitHists();
+    void InitSigmaEngines();
 
     // analysis methods [*.ana.h]
+    void EvaluateCutExpression();
+    void BuildTruthIndex();
     void ApplyFlatDeltaPtCuts();
+    void SkipFlatDeltaPtCuts();
+    void RebuildFlatDeltaPtCuts();
+    void RebuildPtDependentDeltaPtCuts();
     void ApplyPtDependentDeltaPtCuts();
     void FillTruthHistograms();
     void CreateSigmaGraphs();
     void CalculateRejectionFactors();
+    void CalculateCutFlow();
+    void CalculateSectorMask();
+    void CalculateBootstrapIntervals();
+    void CalculateTruthMatching();
+    void GroupTracksByParticle();
     void CalculateEfficiencies();
+    void FillHistsFromStore(vector<SVariantHist>& engines, const vector<uint64_t>& passMasks, const uint64_t passAll, const SFitPool& pool);
+    void ExportFlatCutHists();
+    void ExportSigmaCutHists();
+    TH1* GetFlatCutHist(const size_t iHist, const size_t iCut);
+    TH1* GetSigmaCutHist(const size_t iHist, const size_t iSig);
+    void SetFlatCutHist(const size_t iHist, const size_t iCut, TH1* hist);
+    void SetSigmaCutHist(const size_t iHist, const size_t iSig, TH1* hist);
+    TH1* MakeCutHist(const TString& sName, const size_t iHist);
+    uint32_t GetGeneralCutMask() const;
+    size_t GetBootCounter(const Boot set, const size_t index) const;
+    void MatchTrackToTruth(const uint64_t variants);
+    void GetDenseSlices(const SFitPool& pool);
+    TH1D* MakeSliceHist(const TString sName, const uint32_t iBinLo, const uint32_t iBinHi);
+    void BuildBandTables();
+    void FitUnbinnedResolution();
+    void CalculateGeneralCutScan();
+    void CalculateRocSurface();
 
     // plot methods [*.plot.h]
     void SetStyles();
@@ -133,7 +296,8 @@ class SDeltaPtCutStudy {
     array<float, Const::NRange> deltaFitRange = {0.,  0.1};
 
     // projection parameters
-    size_t           nProj = 0;
+    size_t           nProj       = 0;
+    double           ptProjWidth = 0.;
     vector<double>   ptProj;
     vector<TString>  sProjSuffix;
     vector<TString>  sPtProj;
@@ -175,6 +339,14 @@ class SDeltaPtCutStudy {
     array<float, Const::NRange> rFracRange  = {0., 4.};
     array<float, Const::NRange> rDeltaRange = {0., 0.1};
 
+    // histogram binning parameters
+    uint64_t                    nPtBins    = 1000;
+    uint64_t                    nFracBins  = 1000;
+    uint64_t                    nDeltaBins = 5000;
+    array<float, Const::NRange> rPtBins    = {0., 100.};
+    array<float, Const::NRange> rFracBins  = {0., 10.};
+    array<float, Const::NRange> rDeltaBins = {0., 5.};
+
     // general histogram style parameters
     uint32_t fFil       = 0;
     uint32_t fLin       = 1;
@@ -191,6 +363,87 @@ class SDeltaPtCutStudy {
     size_t   nEffRebin  = 5;
     bool     doEffRebin = true;
 
+    // fill buffer parameters (threads are also used for deferred fills)
+    size_t nFillBuffer  = 1024;
+    size_t nFillThreads = 1;
+    bool   doFillBuffer = false;
+
+    // track store parameters
+    bool doTrackStore = false;
+    bool doDeferHists = false;
+    bool doSaveStore  = true;
+
+    // rebuild parameters (refill from an earlier output's track store)
+    TString sRebuildFile   = "";
+    bool    doRebuildHists = false;
+
+    // parallel fit parameters
+    size_t nFitThreads    = 0;
+    bool   doParallelFits = false;
+
+    // slice estimator parameters
+    double nSliceSigTrunc    = 2.;
+    size_t nSliceMaxIter     = 20;
+    bool   doFastSlices      = false;
+    bool   doSliceCrossCheck = false;
+
+    // dense slice parameters
+    double nDenseMinEntries = 100.;
+    size_t nDenseMaxGroup   = 10;
+    bool   doDenseSlices    = false;
+
+    // band table parameters
+    uint32_t nBandTableBins  = 0;
+    bool     doBandTables    = false;
+    bool     doQuantileBands = false;
+
+    // calibration cache parameters
+    TString sCacheFile      = "SDeltaPtCutStudy.calib.root";
+    bool    doCalibCache    = false;
+    bool    doSkipFlatOnHit = false;
+
+    // unbinned fit parameters
+    bool doUnbinnedFit = false;
+
+    // cut expression parameters
+    TString sCutExpr  = "";
+    bool    doCutExpr = false;
+
+    // roc surface parameters (axes are ptDelta, |n-sigma|,
+    // quality, nTpc, & nMvtx; empty = default binning)
+    vector<tuple<uint32_t, double, double>> rocAxisParams;
+    bool                                    doRocSurface = false;
+
+    // general cut scan parameters
+    array<vector<double>, SCutScan::Cut::NCut> scanGrids;
+    uint32_t                                   nScanPtBins = 100;
+    bool                                       doCutScan   = false;
+
+    // bootstrap parameters
+    uint32_t nBootReps   = 100;
+    double   bootLevel   = 0.68;
+    uint64_t bootSeed    = 0;
+    bool     doBootstrap = false;
+
+    // truth matching parameters
+    bool doTruthMatch = false;
+
+    // track grouping parameters
+    bool doTrackGroups = false;
+
+    // sector mask parameters (full width in phi around each
+    // boundary; no boundaries = 12 equal tpc sectors)
+    vector<double> maskBoundaries;
+    double         maskWidth    = 0.02;
+    bool           doSectorMask = false;
+
+    // checkpoint parameters
+    TString  sCkptFile    = "";
+    uint64_t nCkptEntries = 0;
+    double   tCkptSeconds = 0.;
+    bool     doCkpt       = false;
+    bool     doResumeCkpt = true;
+
     // track tuple addresses
     float trk_event;
     float trk_seed;
@@ -394,6 +647,12 @@ class SDeltaPtCutStudy {
     vector<double>         sigProj;
     vector<vector<double>> muHiProj;
     vector<vector<double>> muLoProj;
+    vector<double>         ptDense;
+    vector<double>         muDense;
+    vector<double>         sigDense;
+
+    // pt bins behind each dense point
+    vector<pair<uint32_t, uint32_t>> binsDense;
 
     // for flat delta-pt cut rejection
     vector<uint64_t> nNormCut;
@@ -407,6 +666,23 @@ class SDeltaPtCutStudy {
     uint64_t nTrks;
     uint64_t nTrus;
 
+    // checkpoint state
+    Stage                            ckptStage     = Stage::SNone;
+    uint64_t                         ckptEntry     = 0;
+    uint64_t                         ckptLastEntry = 0;
+    chrono::steady_clock::time_point ckptLastTime;
+
+    // interruption state & no. of entries processed per loop
+    static volatile sig_atomic_t isInterrupted;
+    bool     doCatchSignals = true;
+    uint64_t nProcFlat      = 0;
+    uint64_t nProcSigma     = 0;
+    uint64_t nProcTruth     = 0;
+    bool     hasEfficiency  = true;
+    bool     hasFlatLoop    = true;
+    void     (*prevSigInt)(int)  = SIG_DFL;
+    void     (*prevSigTerm)(int) = SIG_DFL;
+
     // general 1d histograms
     TH1D* hEff;
     TH1D* hPtTruth;
@@ -445,6 +721,114 @@ class SDeltaPtCutStudy {
     vector<TH2D*> hPtTrueVsTrackCut;
     vector<TH2D*> hPtTrueVsTrackSig;
 
+    // prefix-sum index over delta-pt vs. track pt
+    SPrefixSum2D psDeltaVsTrack;
+
+    // tabulated sigma bands
+    vector<SBandTable> tabMuHi;
+    vector<SBandTable> tabMuLo;
+
+    // diagnostics of every fit & estimate
+    vector<SFitRecord> fitRecords;
+
+    // compiled cut expression, addresses of its
+    // columns, & decision for each track
+    SCutExpr        cutExpr;
+    vector<float*>  exprAddresses;
+    vector<uint8_t> passExpr;
+
+    // counts of each combination of failed cuts & cut-flow output
+    //   (bits of the sector mask & cut expression are 0 if unused)
+    SCutFlow cutFlow;
+    uint32_t bitSector       = 0;
+    uint32_t bitExpr         = 0;
+    TH1D*    hCutFlow        = NULL;
+    TH1D*    hCutNMinusOne   = NULL;
+    TH1D*    hCutMasks       = NULL;
+    TH2D*    hCutCorrelation = NULL;
+
+    // bootstrap replicas of counters & intervals on
+    // rejection factors & (integrated) efficiencies
+    SBootstrap         boot;
+    TGraphAsymmErrors* grRejCutBoot = NULL;
+    TGraphAsymmErrors* grRejSigBoot = NULL;
+    TGraphAsymmErrors* grEffCutBoot = NULL;
+    TGraphAsymmErrors* grEffSigBoot = NULL;
+
+    // index of truth particles by (event, gtrackID), their
+    // columns, & no. of matched good tracks per cut variant
+    //   (variants are the flat cuts & no cut, in the last slot)
+    STruthIndex      truIndex;
+    vector<uint32_t> truEvent;
+    vector<float>    truPt;
+    vector<uint8_t>  truPrimary;
+    vector<uint16_t> nTruMatch;
+
+    // no. of good tracks matched to primaries, matched to
+    // non-primaries, & without a match per cut variant
+    vector<uint64_t> nMatchTrk;
+    vector<uint64_t> nSecondTrk;
+    vector<uint64_t> nFakeTrk;
+
+    // truth-matched efficiencies & rates
+    TH1D*         hEffMatch     = NULL;
+    vector<TH1D*> hEffMatchCut;
+    TGraph*       grDupRateCut  = NULL;
+    TGraph*       grFakeRateCut = NULL;
+
+    // sector boundary lookup, rejection counters & delta-pt of
+    // tracks passing all other cuts without the mask, delta-pt of
+    // good tracks with it, & distance of tracks to a boundary
+    SSectorMask      sectorMask;
+    vector<uint64_t> nNormNoMask;
+    vector<uint64_t> nWeirdNoMask;
+    TH1D*            hPtDeltaNoMask   = NULL;
+    TH1D*            hPtDeltaWithMask = NULL;
+    TH1D*            hSectorDistance  = NULL;
+    TGraph*          grRejNoMask      = NULL;
+
+    // stored tracks grouped by truth particle, tracks per
+    // particle, & origin of weird tracks per cut variant
+    STrackGroups trkGroups;
+    TH1D*        hTrksPerParticle = NULL;
+    TH2D*        hWeirdOrigin     = NULL;
+
+    // count cubes for normal & weird tracks & roc output
+    SCountCube cubeNorm;
+    SCountCube cubeWeird;
+    TTree*     tRocSurface   = NULL;
+    TGraph*    grParetoFront = NULL;
+
+    // general cut scan & its output
+    SCutScan cutScan;
+    TTree*   tCutScan      = NULL;
+    TH2D*    hPtTrkTruScan = NULL;
+    TH2D*    hEffScan      = NULL;
+
+    // result of unbinned resolution fit
+    array<double, SResolutionModel::NPar> parUnbinned;
+    array<double, SResolutionModel::NPar> errUnbinned;
+
+    // shared axes & contiguous fill engines for track histograms
+    //   (flat-cut engines hold the no-cut histograms in the last slot)
+    SVariantAxis         axPt;
+    SVariantAxis         axFrac;
+    SVariantAxis         axDelta;
+    vector<SVariantHist> vhPtCut;
+    vector<SVariantHist> vhPtSig;
+
+    // fill buffer columns: axes, & (x, y) columns of each engine
+    vector<SVariantAxis>   axFillCols;
+    vector<pair<int, int>> vhFillCols;
+
+    // names of cut-variant histograms, [engine][variant]: these
+    // are only created when their engine is exported
+    vector<vector<TString>> sFlatCutNames;
+    vector<vector<TString>> sSigmaCutNames;
+
+    // unbinned store of good tracks & their cut decisions
+    STrackStore trkStore;
+
     // functions
     vector<TF1*> fPtDeltaProj;
     vector<TF1*> fMuHiProj;
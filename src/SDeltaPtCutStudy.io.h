@@ -121,6 +121,41 @@ void SDeltaPtCutStudy::SetPlotRanges(const pair<float, float> ptRange, const pai
 
 
 
+void SDeltaPtCutStudy::SetHistBinning(const uint64_t nPt, const pair<float, float> ptRange, const uint64_t nFrac, const pair<float, float> fracRange, const uint64_t nDelta, const pair<float, float> deltaRange) {
+
+  // an axis needs at least one bin & a non-empty range
+  const bool isGoodPt    = ((nPt > 0)    && (ptRange.second > ptRange.first));
+  const bool isGoodFrac  = ((nFrac > 0)  && (fracRange.second > fracRange.first));
+  const bool isGoodDelta = ((nDelta > 0) && (deltaRange.second > deltaRange.first));
+  if (!isGoodPt || !isGoodFrac || !isGoodDelta) {
+    cerr << "WARNING: bad histogram binning! Keeping previous binning.\n"
+         << "         pt    = " << nPt    << " bins in (" << ptRange.first    << ", " << ptRange.second    << ")\n"
+         << "         frac  = " << nFrac  << " bins in (" << fracRange.first  << ", " << fracRange.second  << ")\n"
+         << "         delta = " << nDelta << " bins in (" << deltaRange.first << ", " << deltaRange.second << ")"
+         << endl;
+    return;
+  }
+
+  nPtBins       = nPt;
+  nFracBins     = nFrac;
+  nDeltaBins    = nDelta;
+  rPtBins[0]    = ptRange.first;
+  rPtBins[1]    = ptRange.second;
+  rFracBins[0]  = fracRange.first;
+  rFracBins[1]  = fracRange.second;
+  rDeltaBins[0] = deltaRange.first;
+  rDeltaBins[1] = deltaRange.second;
+  cout << "    Set histogram binning:\n"
+       << "      pt    = " << nPtBins    << " bins in (" << rPtBins[0]    << ", " << rPtBins[1]    << ")\n"
+       << "      frac  = " << nFracBins  << " bins in (" << rFracBins[0]  << ", " << rFracBins[1]  << ")\n"
+       << "      delta = " << nDeltaBins << " bins in (" << rDeltaBins[0] << ", " << rDeltaBins[1] << ")"
+       << endl;
+  return;
+
+}  // end 'SetHistBinning(uint64_t, pair<float, float>, uint64_t, pair<float, float>, uint64_t, pair<float, float>)'
+
+
+
 void SDeltaPtCutStudy::SetGeneralStyleParameters(const array<uint32_t, Const::NTypes> arrCol, const array<uint32_t, Const::NTypes> arrMar) {
 
   fColTrue = arrCol[0];
@@ -287,10 +322,307 @@ void SDeltaPtCutStudy::SetPtDependCutParameters(const vector<tuple<double, TStri
 
 
 
+void SDeltaPtCutStudy::SetFillBufferParameters(const bool doBuffer, const size_t nBuffer, const size_t nThreads) {
+
+  doFillBuffer = doBuffer;
+  nFillBuffer  = (nBuffer > 0) ? nBuffer : 1;
+  nFillThreads = (nThreads > 0) ? nThreads : 1;
+  cout << "    Set fill buffer parameters:\n"
+       << "      do buffer?  = " << doFillBuffer << "\n"
+       << "      buffer size = " << nFillBuffer  << "\n"
+       << "      no. threads = " << nFillThreads
+       << endl;
+  return;
+
+}  // end 'SetFillBufferParameters(bool, size_t, size_t)'
+
+
+
+void SDeltaPtCutStudy::SetTrackStoreParameters(const bool doStore, const bool doDefer, const bool doSave) {
+
+  doTrackStore = doStore;
+  doDeferHists = doDefer;
+  doSaveStore  = doSave;
+  cout << "    Set track store parameters:\n"
+       << "      do store?   = " << doTrackStore << "\n"
+       << "      do defer?   = " << doDeferHists << "\n"
+       << "      save store? = " << doSaveStore
+       << endl;
+  return;
+
+}  // end 'SetTrackStoreParameters(bool, bool, bool)'
+
+
+
+void SDeltaPtCutStudy::SetRebuildParameters(const bool doRebuild, const TString sFile) {
+
+  doRebuildHists = doRebuild;
+  sRebuildFile   = sFile;
+  cout << "    Set rebuild parameters:\n"
+       << "      do rebuild?  = " << doRebuildHists << "\n"
+       << "      rebuild file = " << sRebuildFile
+       << endl;
+  return;
+
+}  // end 'SetRebuildParameters(bool, TString)'
+
+
+
+void SDeltaPtCutStudy::SetCheckpointParameters(const bool doCheckpoint, const uint64_t nEntries, const double tSeconds, const bool doResume, const TString sFile) {
+
+  doCkpt       = doCheckpoint;
+  nCkptEntries = nEntries;
+  tCkptSeconds = tSeconds;
+  doResumeCkpt = doResume;
+  sCkptFile    = sFile;
+  cout << "    Set checkpoint parameters:\n"
+       << "      do checkpoint?      = " << doCkpt       << "\n"
+       << "      entries per ckpt.   = " << nCkptEntries << "\n"
+       << "      seconds per ckpt.   = " << tCkptSeconds << "\n"
+       << "      resume from ckpt.?  = " << doResumeCkpt << "\n"
+       << "      ckpt. file          = " << sCkptFile
+       << endl;
+  return;
+
+}  // end 'SetCheckpointParameters(bool, uint64_t, double, bool, TString)'
+
+
+
+void SDeltaPtCutStudy::SetSignalHandling(const bool doCatch) {
+
+  doCatchSignals = doCatch;
+  cout << "    Set signal handling:\n"
+       << "      catch SIGINT/SIGTERM? = " << doCatchSignals
+       << endl;
+  return;
+
+}  // end 'SetSignalHandling(bool)'
+
+
+
+void SDeltaPtCutStudy::SetParallelFitParameters(const bool doParallel, const size_t nThreads) {
+
+  doParallelFits = doParallel;
+  nFitThreads    = nThreads;
+  cout << "    Set parallel fit parameters:\n"
+       << "      do parallel fits? = " << doParallelFits << "\n"
+       << "      no. threads       = " << nFitThreads << " (0 = one per core)"
+       << endl;
+  return;
+
+}  // end 'SetParallelFitParameters(bool, size_t)'
+
+
+
+void SDeltaPtCutStudy::SetSliceEstimatorParameters(const bool doFast, const bool doCrossCheck, const double nSigTrunc, const size_t nMaxIter) {
+
+  doFastSlices      = doFast;
+  doSliceCrossCheck = doCrossCheck;
+  nSliceSigTrunc    = nSigTrunc;
+  nSliceMaxIter     = nMaxIter;
+  cout << "    Set slice estimator parameters:\n"
+       << "      use fast estimate?  = " << doFastSlices      << "\n"
+       << "      cross-check w/ fit? = " << doSliceCrossCheck << "\n"
+       << "      truncation (sigma)  = " << nSliceSigTrunc    << "\n"
+       << "      max iterations      = " << nSliceMaxIter
+       << endl;
+  return;
+
+}  // end 'SetSliceEstimatorParameters(bool, bool, double, size_t)'
+
+
+
+void SDeltaPtCutStudy::SetDenseSliceParameters(const bool doDense, const double minEntries, const size_t nMaxGroup) {
+
+  doDenseSlices    = doDense;
+  nDenseMinEntries = (minEntries >= 1.) ? minEntries : 1.;
+  nDenseMaxGroup   = (nMaxGroup > 0) ? nMaxGroup : 1;
+  if (minEntries < 1.) {
+    cerr << "WARNING: min. entries per dense group must be at least 1! Using 1." << endl;
+  }
+  cout << "    Set dense slice parameters:\n"
+       << "      do dense slices?   = " << doDenseSlices    << "\n"
+       << "      min. entries/group = " << nDenseMinEntries << "\n"
+       << "      max. bins/group    = " << nDenseMaxGroup
+       << endl;
+  return;
+
+}  // end 'SetDenseSliceParameters(bool, double, size_t)'
+
+
+
+void SDeltaPtCutStudy::SetProjectionWidth(const double width) {
+
+  ptProjWidth = width;
+  cout << "    Set projection width:\n"
+       << "      width = " << ptProjWidth << " (0 = single pt bin)"
+       << endl;
+  return;
+
+}  // end 'SetProjectionWidth(double)'
+
+
+
+void SDeltaPtCutStudy::SetBandTableParameters(const bool doTable, const bool doQuantiles, const uint32_t nTableBins) {
+
+  doBandTables    = doTable;
+  doQuantileBands = doQuantiles;
+  nBandTableBins  = nTableBins;
+  cout << "    Set band table parameters:\n"
+       << "      use band tables?    = " << doBandTables    << "\n"
+       << "      use quantile bands? = " << doQuantileBands << "\n"
+       << "      no. table bins      = " << nBandTableBins  << " (0 = pt binning)"
+       << endl;
+  return;
+
+}  // end 'SetBandTableParameters(bool, bool, uint32_t)'
+
+
+
+void SDeltaPtCutStudy::SetCalibrationCacheParameters(const bool doCache, const TString sFile, const bool doSkipFlat) {
+
+  doCalibCache    = doCache;
+  sCacheFile      = sFile;
+  doSkipFlatOnHit = doSkipFlat;
+  cout << "    Set calibration cache parameters:\n"
+       << "      use cache?             = " << doCalibCache      << "\n"
+       << "      cache file             = " << sCacheFile.Data() << "\n"
+       << "      skip 1st loop on hit?  = " << doSkipFlatOnHit
+       << endl;
+  return;
+
+}  // end 'SetCalibrationCacheParameters(bool, TString, bool)'
+
+
+
+void SDeltaPtCutStudy::SetUnbinnedFitParameters(const bool doUnbinned) {
+
+  doUnbinnedFit = doUnbinned;
+  cout << "    Set unbinned fit parameters:\n"
+       << "      do unbinned fit? = " << doUnbinnedFit
+       << endl;
+  return;
+
+}  // end 'SetUnbinnedFitParameters(bool)'
+
+
+
+void SDeltaPtCutStudy::SetCutExpression(const TString sExpr) {
+
+  sCutExpr  = sExpr;
+  doCutExpr = !sCutExpr.IsNull();
+  cout << "    Set cut expression:\n"
+       << "      expression = '" << sCutExpr.Data() << "'"
+       << endl;
+  return;
+
+}  // end 'SetCutExpression(TString)'
+
+
+
+void SDeltaPtCutStudy::SetRocSurfaceParameters(const bool doRoc, const vector<tuple<uint32_t, double, double>> rocAxes) {
+
+  doRocSurface  = doRoc;
+  rocAxisParams = rocAxes;
+  cout << "    Set roc surface parameters:\n"
+       << "      do roc surface? = " << doRocSurface << "\n"
+       << "      no. axes given  = " << rocAxisParams.size() << " (0 = default binning)"
+       << endl;
+  return;
+
+}  // end 'SetRocSurfaceParameters(bool, vector<tuple<uint32_t, double, double>>)'
+
+
+
+void SDeltaPtCutStudy::SetGeneralCutScanParameters(const bool doScan, const array<vector<double>, SCutScan::Cut::NCut> grids, const uint32_t nSpecBins) {
+
+  doCutScan   = doScan;
+  scanGrids   = grids;
+  nScanPtBins = nSpecBins;
+  cout << "    Set general cut scan parameters:\n"
+       << "      do scan?          = " << doCutScan   << "\n"
+       << "      no. spectrum bins = " << nScanPtBins << "\n"
+       << "      no. grid values   = (";
+  for (size_t iCut = 0; iCut < SCutScan::Cut::NCut; iCut++) {
+    cout << scanGrids[iCut].size() << ((iCut + 1 < SCutScan::Cut::NCut) ? ", " : ")");
+  }
+  cout << endl;
+  return;
+
+}  // end 'SetGeneralCutScanParameters(bool, array<vector<double>, NCut>, uint32_t)'
+
+
+
+void SDeltaPtCutStudy::SetBootstrapParameters(const bool doBoot, const uint32_t nReplicas, const double level, const uint64_t seed) {
+
+  doBootstrap = doBoot;
+  nBootReps   = nReplicas;
+  bootLevel   = level;
+  bootSeed    = seed;
+  cout << "    Set bootstrap parameters:\n"
+       << "      do bootstrap?    = " << doBootstrap << "\n"
+       << "      no. replicas     = " << nBootReps   << "\n"
+       << "      confidence level = " << bootLevel   << "\n"
+       << "      seed             = " << bootSeed
+       << endl;
+  return;
+
+}  // end 'SetBootstrapParameters(bool, uint32_t, double, uint64_t)'
+
+
+
+void SDeltaPtCutStudy::SetTruthMatchParameters(const bool doMatch) {
+
+  doTruthMatch = doMatch;
+  cout << "    Set truth matching parameters:\n"
+       << "      do truth matching? = " << doTruthMatch
+       << endl;
+  return;
+
+}  // end 'SetTruthMatchParameters(bool)'
+
+
+
+void SDeltaPtCutStudy::SetTrackGroupParameters(const bool doGroup) {
+
+  doTrackGroups = doGroup;
+  cout << "    Set track grouping parameters:\n"
+       << "      do track grouping? = " << doTrackGroups
+       << endl;
+  return;
+
+}  // end 'SetTrackGroupParameters(bool)'
+
+
+
+void SDeltaPtCutStudy::SetSectorMaskParameters(const bool doMask, const double width, const vector<double> boundaries) {
+
+  doSectorMask   = doMask;
+  maskWidth      = width;
+  maskBoundaries = boundaries;
+  cout << "    Set sector mask parameters:\n"
+       << "      do sector mask? = " << doSectorMask << "\n"
+       << "      mask width      = " << maskWidth << "\n"
+       << "      no. boundaries  = " << (maskBoundaries.empty() ? SSectorMask::NSectors : maskBoundaries.size())
+       << endl;
+  return;
+
+}  // end 'SetSectorMaskParameters(bool, double, vector<double>)'
+
+
+
 // private io methods ---------------------------------------------------------
 
 void SDeltaPtCutStudy::OpenFiles() {
 
+  // output is recreated, so it can't be what's rebuilt from
+  if (doRebuildHists && (sRebuildFile == sOutFile)) {
+    cerr << "PANIC: can't rebuild from the output file!\n"
+         << "       file = " << sOutFile.Data() << "\n"
+         << endl;
+    assert(sRebuildFile != sOutFile);
+  }
+
   fOutput = new TFile(sOutFile.Data(), "recreate");
   fInput  = new TFile(sInFile.Data(),  "read");
   if (!fInput || !fOutput) {
@@ -329,6 +661,21 @@ void SDeltaPtCutStudy::GetTuples() {
 
 void SDeltaPtCutStudy::SaveOutput() {
 
+  // record whether output is partial & how much was processed
+  TParameter<int>      parPartial("isPartial", isInterrupted ? 1 : 0);
+  TParameter<int>      parHasEff("hasEfficiency", hasEfficiency ? 1 : 0);
+  TParameter<int>      parHasFlat("hasFlatLoop", hasFlatLoop ? 1 : 0);
+  TParameter<Long64_t> parProcFlat("nProcFlat", nProcFlat);
+  TParameter<Long64_t> parProcSig("nProcSigma", nProcSigma);
+  TParameter<Long64_t> parProcTru("nProcTruth", nProcTruth);
+  fOutput -> cd();
+  parPartial.Write();
+  parHasEff.Write();
+  parHasFlat.Write();
+  parProcFlat.Write();
+  parProcSig.Write();
+  parProcTru.Write();
+
   // make directories
   TDirectory *dNoCut    = (TDirectory*) fOutput -> mkdir("NoCuts");
   TDirectory *dFlatCut  = (TDirectory*) fOutput -> mkdir("FlatCuts");
@@ -353,6 +700,10 @@ void SDeltaPtCutStudy::SaveOutput() {
   // save flat delta-pt cut histograms
   dFlatCut -> cd();
   grRejCut -> Write();
+  if (grRejCutBoot) {
+    grRejCutBoot -> Write();
+    grEffCutBoot -> Write();
+  }
   for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
     hEffCut[iCut]            -> Write();
     hPtDeltaCut[iCut]        -> Write();
@@ -368,6 +719,10 @@ void SDeltaPtCutStudy::SaveOutput() {
   // save pt-dependent delta-pt cut histograms
   dSigmaCut -> cd();
   grRejSig  -> Write();
+  if (grRejSigBoot) {
+    grRejSigBoot -> Write();
+    grEffSigBoot -> Write();
+  }
   for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
     hEffSig[iSig]            -> Write();
     hPtDeltaSig[iSig]        -> Write();
@@ -394,6 +749,78 @@ void SDeltaPtCutStudy::SaveOutput() {
     grMuHiProj[iSig] -> Write();
     grMuLoProj[iSig] -> Write();
   }
+  if (!fitRecords.empty()) {
+    MakeFitRecordTree(fitRecords, "FitDiagnostics") -> Write();
+  }
+  if (doRocSurface) {
+    TDirectory* dRoc = (TDirectory*) fOutput -> mkdir("RocSurface");
+    dRoc          -> cd();
+    tRocSurface   -> Write();
+    grParetoFront -> Write();
+    dProject      -> cd();
+  }
+  if (tCutScan) {
+    TDirectory* dScan = (TDirectory*) fOutput -> mkdir("GeneralCutScan");
+    dScan         -> cd();
+    tCutScan      -> Write();
+    hPtTrkTruScan -> Write();
+    hEffScan      -> Write();
+    dProject      -> cd();
+  }
+  if (doUnbinnedFit) {
+    const TVectorD tvecParUnbinned(parUnbinned.size(), parUnbinned.data());
+    const TVectorD tvecErrUnbinned(errUnbinned.size(), errUnbinned.data());
+    dProject -> WriteTObject(&tvecParUnbinned, "UnbinnedResolutionPar");
+    dProject -> WriteTObject(&tvecErrUnbinned, "UnbinnedResolutionErr");
+  }
+
+  // save truth matching
+  if (hEffMatch) {
+    TDirectory* dMatch = (TDirectory*) fOutput -> mkdir("TruthMatch");
+    dMatch        -> cd();
+    hEffMatch     -> Write();
+    grDupRateCut  -> Write();
+    grFakeRateCut -> Write();
+    for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
+      hEffMatchCut[iCut] -> Write();
+    }
+  }
+
+  // save track groups
+  if (hWeirdOrigin) {
+    TDirectory* dGroup = (TDirectory*) fOutput -> mkdir("TrackGroups");
+    dGroup           -> cd();
+    hTrksPerParticle -> Write();
+    hWeirdOrigin     -> Write();
+  }
+
+  // save sector mask comparison
+  if (grRejNoMask) {
+    TDirectory* dMask = (TDirectory*) fOutput -> mkdir("SectorMask");
+    dMask            -> cd();
+    hPtDeltaNoMask   -> Write();
+    hPtDeltaWithMask -> Write();
+    hSectorDistance  -> Write();
+    grRejNoMask      -> Write();
+  }
+
+  // save cut flow
+  if (hCutFlow) {
+    TDirectory* dFlow = (TDirectory*) fOutput -> mkdir("CutFlow");
+    dFlow           -> cd();
+    hCutFlow        -> Write();
+    hCutNMinusOne   -> Write();
+    hCutMasks       -> Write();
+    hCutCorrelation -> Write();
+  }
+
+  // save track store
+  if (doTrackStore && doSaveStore) {
+    TDirectory *dStore = (TDirectory*) fOutput -> mkdir("TrackStore");
+    dStore -> cd();
+    TTree* tStore = trkStore.MakeTree("tTrackStore");
+    tStore -> Write();
+  }
 
   cout << "      Saved output." << endl;
   return;
@@ -414,4 +841,592 @@ void SDeltaPtCutStudy::CloseFiles() {
 
 }  // end 'CloseFiles()'
 
+
+
+void SDeltaPtCutStudy::ReadTrackStore() {
+
+  // store is read from the output of an earlier run
+  TFile* fStore = new TFile(sRebuildFile.Data(), "read");
+  TTree* tStore = (fStore && !fStore -> IsZombie()) ? fStore -> Get<TTree>("TrackStore/tTrackStore") : NULL;
+  if (!tStore) {
+    cerr << "PANIC: couldn't grab track store to rebuild from!\n"
+         << "       file   = " << sRebuildFile.Data() << "\n"
+         << "       tStore = " << tStore << "\n"
+         << endl;
+    assert(tStore);
+  }
+  trkStore.ReadTree(tStore);
+  fStore  -> Close();
+  fOutput -> cd();
+
+  // stored decisions are reused as is, so drop
+  // bits of cuts that don't exist in this setup
+  const uint64_t maskCut = (1ULL << nDPtCuts) - 1;
+  const uint64_t maskSig = (nSigCuts < 64) ? ((1ULL << nSigCuts) - 1) : ~0ULL;
+  for (size_t iTrk = 0; iTrk < trkStore.GetSize(); iTrk++) {
+    trkStore.passCut[iTrk] &= maskCut;
+    trkStore.passSig[iTrk] &= maskSig;
+  }
+
+  cout << "      Read " << trkStore.GetSize() << " stored tracks from '" << sRebuildFile.Data() << "'." << endl;
+  return;
+
+}  // end 'ReadTrackStore()'
+
+
+
+void SDeltaPtCutStudy::WriteCheckpoint(const Stage stage, const uint64_t iEntry) {
+
+  if (!doCkpt) return;
+
+  // write to a temporary file first, so an
+  // interrupted write never clobbers the last one
+  TString sTmpFile(sCkptFile.Data());
+  sTmpFile.Append(".tmp");
+
+  TFile* fCkpt = new TFile(sTmpFile.Data(), "recreate");
+  if (!fCkpt || fCkpt -> IsZombie()) {
+    cerr << "WARNING: couldn't open checkpoint file '" << sTmpFile.Data() << "'! Skipping checkpoint." << endl;
+    fOutput -> cd();
+    return;
+  }
+
+  // loop state & counters
+  const double   state[] = {(double) stage, (double) iEntry, (double) nTrks, (double) nDPtCuts, (double) nSigCuts};
+  const TVectorD tvecState(5, state);
+  TVectorD tvecNormCut(nDPtCuts);
+  TVectorD tvecWeirdCut(nDPtCuts);
+  TVectorD tvecNormSig(nSigCuts);
+  TVectorD tvecWeirdSig(nSigCuts);
+  for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
+    tvecNormCut[iCut]  = nNormCut[iCut];
+    tvecWeirdCut[iCut] = nWeirdCut[iCut];
+  }
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    tvecNormSig[iSig]  = nNormSig[iSig];
+    tvecWeirdSig[iSig] = nWeirdSig[iSig];
+  }
+  const TNamed  namKey("ckptKey", GetCheckpointKey().Data());
+  fCkpt -> WriteTObject(&namKey,       "ckptKey");
+  fCkpt -> WriteTObject(&tvecState,    "ckptState");
+  fCkpt -> WriteTObject(&tvecNormCut,  "ckptNormCut");
+  fCkpt -> WriteTObject(&tvecWeirdCut, "ckptWeirdCut");
+  fCkpt -> WriteTObject(&tvecNormSig,  "ckptNormSig");
+  fCkpt -> WriteTObject(&tvecWeirdSig, "ckptWeirdSig");
+
+  // cut-flow counts
+  const vector<uint64_t>& flowCounts = cutFlow.GetCounts();
+  TVectorD tvecCutFlow(flowCounts.size());
+  for (size_t iMask = 0; iMask < flowCounts.size(); iMask++) {
+    tvecCutFlow[iMask] = flowCounts[iMask];
+  }
+  fCkpt -> WriteTObject(&tvecCutFlow, "ckptCutFlow");
+
+  // bootstrap counts
+  if (doBootstrap) {
+    const vector<uint64_t>& bootCounts = boot.GetCounts();
+    TVectorD tvecBoot(bootCounts.size());
+    for (size_t iCell = 0; iCell < bootCounts.size(); iCell++) {
+      tvecBoot[iCell] = bootCounts[iCell];
+    }
+    fCkpt -> WriteTObject(&tvecBoot, "ckptBootstrap");
+  }
+
+  // flat-cut histograms (final once 1st loop is done)
+  TDirectory* dFlatCut = fCkpt -> mkdir("FlatCuts");
+  dFlatCut -> cd();
+  if (stage == Stage::SFlat) {
+    WriteCutHists(vhPtCut, sFlatCutNames);
+  } else {
+    for (size_t iHist = 0; iHist < Hist::NHist; iHist++) {
+      for (size_t iCut = 0; iCut <= nDPtCuts; iCut++) {
+        GetFlatCutHist(iHist, iCut) -> Write();
+      }
+    }
+  }
+
+  // pt-dependent-cut histograms (once the 2nd loop started) & sigma bands
+  if (stage == Stage::SSigma) {
+    TDirectory* dSigmaCut = fCkpt -> mkdir("SigmaCuts");
+    dSigmaCut -> cd();
+    if (!vhPtSig.empty()) WriteCutHists(vhPtSig, sSigmaCutNames);
+    for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+      fMuHiProj[iSig] -> Write();
+      fMuLoProj[iSig] -> Write();
+    }
+  }
+
+  // track store
+  if (doTrackStore) {
+    fCkpt -> cd();
+    TTree* tStore = trkStore.MakeTree("tTrackStore");
+    tStore -> Write();
+  }
+
+  // close & move into place
+  fCkpt   -> Close();
+  fOutput -> cd();
+  gSystem -> Rename(sTmpFile.Data(), sCkptFile.Data());
+
+  // reset interval
+  ckptLastEntry = iEntry;
+  ckptLastTime  = chrono::steady_clock::now();
+
+  cout << "\n        Wrote checkpoint at entry " << iEntry << " of loop " << (uint32_t) stage << " to '" << sCkptFile.Data() << "'." << endl;
+  return;
+
+}  // end 'WriteCheckpoint(Stage, uint64_t)'
+
+
+
+void SDeltaPtCutStudy::ReadCheckpoint() {
+
+  // default to starting from scratch
+  ckptStage     = Stage::SNone;
+  ckptEntry     = 0;
+  ckptLastEntry = 0;
+  ckptLastTime  = chrono::steady_clock::now();
+  if (!doCkpt) return;
+
+  // by default, put checkpoint next to output
+  if (sCkptFile.IsNull()) {
+    sCkptFile = sOutFile;
+    sCkptFile.ReplaceAll(".root", "");
+    sCkptFile.Append(".checkpoint.root");
+  }
+  if (!doResumeCkpt || gSystem -> AccessPathName(sCkptFile.Data())) {
+    cout << "      No checkpoint to resume from, starting from scratch." << endl;
+    return;
+  }
+
+  TFile* fCkpt = new TFile(sCkptFile.Data(), "read");
+  if (!fCkpt || fCkpt -> IsZombie()) {
+    cerr << "WARNING: couldn't open checkpoint file '" << sCkptFile.Data() << "'! Starting from scratch." << endl;
+    fOutput -> cd();
+    return;
+  }
+
+  // make sure checkpoint is from the same input & setup
+  TNamed*    namKey     = fCkpt -> Get<TNamed>("ckptKey");
+  TVectorD*  tvecState  = fCkpt -> Get<TVectorD>("ckptState");
+  TTree*     tStore     = fCkpt -> Get<TTree>("tTrackStore");
+  const bool isGoodCkpt = (
+    namKey &&
+    (GetCheckpointKey() == namKey -> GetTitle()) &&
+    tvecState &&
+    (tvecState -> GetNrows() == 5) &&
+    ((uint64_t) (*tvecState)[2] == nTrks) &&
+    ((size_t) (*tvecState)[3] == nDPtCuts) &&
+    ((size_t) (*tvecState)[4] == nSigCuts) &&
+    (!doTrackStore || tStore)
+  );
+  if (!isGoodCkpt) {
+    cerr << "WARNING: checkpoint '" << sCkptFile.Data() << "' doesn't match current input or setup! Starting from scratch." << endl;
+    fCkpt   -> Close();
+    fOutput -> cd();
+    return;
+  }
+  ckptStage = (Stage) (*tvecState)[0];
+  ckptEntry = (uint64_t) (*tvecState)[1];
+
+  // restore counters
+  TVectorD* tvecNormCut  = fCkpt -> Get<TVectorD>("ckptNormCut");
+  TVectorD* tvecWeirdCut = fCkpt -> Get<TVectorD>("ckptWeirdCut");
+  TVectorD* tvecNormSig  = fCkpt -> Get<TVectorD>("ckptNormSig");
+  TVectorD* tvecWeirdSig = fCkpt -> Get<TVectorD>("ckptWeirdSig");
+  for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
+    nNormCut[iCut]  = (uint64_t) (*tvecNormCut)[iCut];
+    nWeirdCut[iCut] = (uint64_t) (*tvecWeirdCut)[iCut];
+  }
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    nNormSig[iSig]  = (uint64_t) (*tvecNormSig)[iSig];
+    nWeirdSig[iSig] = (uint64_t) (*tvecWeirdSig)[iSig];
+  }
+
+  // restore cut-flow counts (if the same cuts were counted)
+  TVectorD* tvecCutFlow = fCkpt -> Get<TVectorD>("ckptCutFlow");
+  if (tvecCutFlow && ((size_t) tvecCutFlow -> GetNrows() == cutFlow.GetCounts().size())) {
+    for (int iMask = 0; iMask < tvecCutFlow -> GetNrows(); iMask++) {
+      cutFlow.SetCount(iMask, (uint64_t) (*tvecCutFlow)[iMask]);
+    }
+  } else {
+    cerr << "WARNING: checkpoint has no matching cut-flow counts! Cut flow won't include earlier tracks." << endl;
+  }
+
+  // restore bootstrap counts (if the same replicas were counted)
+  if (doBootstrap) {
+    TVectorD* tvecBoot = fCkpt -> Get<TVectorD>("ckptBootstrap");
+    if (tvecBoot && ((size_t) tvecBoot -> GetNrows() == boot.GetCounts().size())) {
+      for (int iCell = 0; iCell < tvecBoot -> GetNrows(); iCell++) {
+        boot.SetCount(iCell, (uint64_t) (*tvecBoot)[iCell]);
+      }
+    } else {
+      cerr << "WARNING: checkpoint has no matching bootstrap counts! Bootstrap won't include earlier tracks." << endl;
+    }
+  }
+
+  // restore flat-cut histogram contents (pt-dependent ones
+  // are restored once their engines exist in the 2nd loop)
+  for (size_t iHist = 0; iHist < Hist::NHist; iHist++) {
+    for (size_t iCut = 0; iCut <= nDPtCuts; iCut++) {
+      TString sHist("FlatCuts/");
+      sHist.Append(sFlatCutNames[iHist][iCut].Data());
+      vhPtCut[iHist].Import(iCut, fCkpt -> Get<TH1>(sHist.Data()));
+    }
+  }
+
+  // restore track store
+  if (doTrackStore) trkStore.ReadTree(tStore);
+
+  fCkpt   -> Close();
+  fOutput -> cd();
+
+  cout << "      Resuming from checkpoint '" << sCkptFile.Data() << "' at entry " << ckptEntry << " of loop " << (uint32_t) ckptStage << "." << endl;
+  return;
+
+}  // end 'ReadCheckpoint()'
+
+
+
+void SDeltaPtCutStudy::ReadCheckpointSigmaHists() {
+
+  // a checkpoint from before the 2nd loop started has none
+  if (ckptEntry == 0) return;
+
+  TFile* fCkpt = new TFile(sCkptFile.Data(), "read");
+  if (!fCkpt || fCkpt -> IsZombie()) {
+    cerr << "PANIC: couldn't reopen checkpoint file '" << sCkptFile.Data() << "'!" << endl;
+    assert(fCkpt && !fCkpt -> IsZombie());
+  }
+
+  for (size_t iHist = 0; iHist < Hist::NHist; iHist++) {
+    for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+      TString sHist("SigmaCuts/");
+      sHist.Append(sSigmaCutNames[iHist][iSig].Data());
+      vhPtSig[iHist].Import(iSig, fCkpt -> Get<TH1>(sHist.Data()));
+    }
+  }
+  fCkpt   -> Close();
+  fOutput -> cd();
+
+  cout << "      Restored pt-dependent cut histograms from checkpoint." << endl;
+  return;
+
+}  // end 'ReadCheckpointSigmaHists()'
+
+
+
+void SDeltaPtCutStudy::WriteCutHists(const vector<SVariantHist>& engines, const vector<vector<TString>>& sNames) {
+
+  // one variant at a time into the current directory,
+  // so a full copy of the engines is never held
+  for (size_t iHist = 0; iHist < engines.size(); iHist++) {
+    for (size_t iVar = 0; iVar < engines[iHist].GetNVariants(); iVar++) {
+      TH1* hist = MakeCutHist(sNames[iHist][iVar], iHist);
+      engines[iHist].Export(iVar, hist);
+      hist -> Write();
+      delete hist;
+    }
+  }
+  return;
+
+}  // end 'WriteCutHists(vector<SVariantHist>&, vector<vector<TString>>&)'
+
+
+
+void SDeltaPtCutStudy::ReadCheckpointBands() {
+
+  TFile* fCkpt = new TFile(sCkptFile.Data(), "read");
+  if (!fCkpt || fCkpt -> IsZombie()) {
+    cerr << "PANIC: couldn't reopen checkpoint file '" << sCkptFile.Data() << "'!" << endl;
+    assert(fCkpt && !fCkpt -> IsZombie());
+  }
+
+  // use the checkpointed sigma bands, so the resumed
+  // loop applies exactly the same cuts as before
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    TString sMuHi("SigmaCuts/");
+    TString sMuLo("SigmaCuts/");
+    sMuHi.Append(fMuHiProj[iSig] -> GetName());
+    sMuLo.Append(fMuLoProj[iSig] -> GetName());
+
+    TF1* fMuHiCkpt = fCkpt -> Get<TF1>(sMuHi.Data());
+    TF1* fMuLoCkpt = fCkpt -> Get<TF1>(sMuLo.Data());
+    if (!fMuHiCkpt || !fMuLoCkpt) {
+      cerr << "WARNING: sigma band #" << iSig << " missing from checkpoint! Using refit band." << endl;
+      continue;
+    }
+    fMuHiProj[iSig] -> SetParameters(fMuHiCkpt -> GetParameters());
+    fMuLoProj[iSig] -> SetParameters(fMuLoCkpt -> GetParameters());
+  }
+  fCkpt   -> Close();
+  fOutput -> cd();
+
+  cout << "      Restored sigma bands from checkpoint." << endl;
+  return;
+
+}  // end 'ReadCheckpointBands()'
+
+
+
+bool SDeltaPtCutStudy::IsCheckpointDue(const uint64_t iEntry) {
+
+  // clock is only checked every so often
+  const uint64_t nClockCheck = 1024;
+  if (!doCkpt || (iEntry <= ckptLastEntry)) return false;
+
+  const bool isEntryDue = ((nCkptEntries > 0) && ((iEntry - ckptLastEntry) >= nCkptEntries));
+  bool       isTimeDue  = false;
+  if ((tCkptSeconds > 0.) && ((iEntry % nClockCheck) == 0)) {
+    const chrono::duration<double> tElapsed = chrono::steady_clock::now() - ckptLastTime;
+    isTimeDue = (tElapsed.count() >= tCkptSeconds);
+  }
+  return (isEntryDue || isTimeDue);
+
+}  // end 'IsCheckpointDue(uint64_t)'
+
+
+
+void SDeltaPtCutStudy::RemoveCheckpoint() {
+
+  if (!doCkpt || sCkptFile.IsNull() || gSystem -> AccessPathName(sCkptFile.Data())) return;
+
+  // only a complete, cleanly written output replaces the checkpoint
+  if (isInterrupted || fOutput -> TestBit(TFile::kWriteError)) {
+    cout << "      Kept checkpoint '" << sCkptFile.Data() << "'." << endl;
+    return;
+  }
+  gSystem -> Unlink(sCkptFile.Data());
+  cout << "      Removed checkpoint '" << sCkptFile.Data() << "'." << endl;
+  return;
+
+}  // end 'RemoveCheckpoint()'
+
+
+
+TString SDeltaPtCutStudy::GetCheckpointKey() {
+
+  // everything the sigma bands depend on, plus what else
+  // goes into the loop counters & histograms
+  ostringstream config;
+  config << setprecision(17)
+         << GetCalibrationKey().Data() << " " << nDPtCuts << " "
+         << axFrac.nBins << " " << axFrac.xMin << " " << axFrac.xMax << " "
+         << doTrackStore << " " << doBootstrap << " " << nBootReps << " " << bootSeed << " ";
+  for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
+    config << ptDeltaMax[iCut] << " ";
+  }
+  return HashConfig("ckpt_", config.str());
+
+}  // end 'GetCheckpointKey()'
+
+
+
+bool SDeltaPtCutStudy::IsInCalibrationCache() {
+
+  if (!doCalibCache || gSystem -> AccessPathName(sCacheFile.Data())) return false;
+
+  TFile* fCache = new TFile(sCacheFile.Data(), "read");
+  if (!fCache || fCache -> IsZombie()) {
+    cerr << "WARNING: couldn't open calibration cache '" << sCacheFile.Data() << "'! Ignoring cache." << endl;
+    fOutput -> cd();
+    return false;
+  }
+
+  const bool isInCache = (fCache -> GetDirectory(GetCalibrationKey().Data()) != NULL);
+  fCache  -> Close();
+  fOutput -> cd();
+  return isInCache;
+
+}  // end 'IsInCalibrationCache()'
+
+
+
+bool SDeltaPtCutStudy::ReadCalibrationCache() {
+
+  const TString sKey = GetCalibrationKey();
+
+  TFile* fCache = new TFile(sCacheFile.Data(), "read");
+  if (!fCache || fCache -> IsZombie()) {
+    cerr << "WARNING: couldn't open calibration cache '" << sCacheFile.Data() << "'! Refitting." << endl;
+    fOutput -> cd();
+    return false;
+  }
+
+  // grab a cached object & detach it from the cache
+  TDirectory* dCache   = fCache -> GetDirectory(sKey.Data());
+  bool        isIntact = (dCache != NULL);
+  auto getCached = [&](const TString sName) {
+    TObject* object = isIntact ? dCache -> Get(sName.Data()) : NULL;
+    if (!object) {
+      isIntact = false;
+      return (TObject*) NULL;
+    }
+    return object -> Clone();
+  };  // end 'getCached(TString)'
+
+  // projections
+  fOutput -> cd();
+  for (size_t iProj = 0; iProj < nProj; iProj++) {
+    TString sIndex("_");
+    sIndex += iProj;
+    hPtDeltaProj[iProj] = (TH1D*) getCached("hProj" + sIndex);
+    fPtDeltaProj[iProj] = (TF1*)  getCached("fProj" + sIndex);
+  }
+
+  // sigma graphs & bands
+  grMuProj  = (TGraph*) getCached("grMuProj");
+  grSigProj = (TGraph*) getCached("grSigProj");
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    TString sIndex("_");
+    sIndex += iSig;
+    grMuHiProj[iSig] = (TGraph*) getCached("grMuHi" + sIndex);
+    grMuLoProj[iSig] = (TGraph*) getCached("grMuLo" + sIndex);
+    fMuHiProj[iSig]  = (TF1*)    getCached("fMuHi" + sIndex);
+    fMuLoProj[iSig]  = (TF1*)    getCached("fMuLo" + sIndex);
+  }
+
+  // projection means & widths
+  TVectorD* tvecMuProj  = (TVectorD*) getCached("muProj");
+  TVectorD* tvecSigProj = (TVectorD*) getCached("sigProj");
+  if (isIntact) {
+    for (size_t iProj = 0; iProj < nProj; iProj++) {
+      muProj[iProj]  = (*tvecMuProj)[iProj];
+      sigProj[iProj] = (*tvecSigProj)[iProj];
+    }
+  }
+  fCache  -> Close();
+  fOutput -> cd();
+
+  if (!isIntact) {
+    cerr << "WARNING: calibration cache entry '" << sKey.Data() << "' is incomplete! Refitting." << endl;
+    return false;
+  }
+  for (size_t iProj = 0; iProj < nProj; iProj++) {
+    hPtDeltaProj[iProj] -> SetDirectory(fOutput);
+  }
+
+  // tabulate bands if needed
+  if (doBandTables) BuildBandTables();
+
+  cout << "      Read sigma graphs and bands from calibration cache (" << sKey.Data() << ")." << endl;
+  return true;
+
+}  // end 'ReadCalibrationCache()'
+
+
+
+void SDeltaPtCutStudy::WriteCalibrationCache() {
+
+  if (!doCalibCache) return;
+
+  const TString sKey = GetCalibrationKey();
+
+  TFile* fCache = new TFile(sCacheFile.Data(), "update");
+  if (!fCache || fCache -> IsZombie()) {
+    cerr << "WARNING: couldn't open calibration cache '" << sCacheFile.Data() << "'! Not caching." << endl;
+    fOutput -> cd();
+    return;
+  }
+
+  // only called if the entry couldn't be read, so
+  // an existing one is incomplete: replace it
+  if (fCache -> GetDirectory(sKey.Data())) {
+    cerr << "WARNING: replacing incomplete calibration cache entry '" << sKey.Data() << "'." << endl;
+    fCache -> Delete(sKey + ";*");
+  }
+  TDirectory* dCache = fCache -> mkdir(sKey.Data());
+  dCache -> cd();
+
+  // projections
+  for (size_t iProj = 0; iProj < nProj; iProj++) {
+    TString sIndex("_");
+    sIndex += iProj;
+    dCache -> WriteTObject(hPtDeltaProj[iProj], "hProj" + sIndex);
+    dCache -> WriteTObject(fPtDeltaProj[iProj], "fProj" + sIndex);
+  }
+
+  // sigma graphs & bands
+  dCache -> WriteTObject(grMuProj,  "grMuProj");
+  dCache -> WriteTObject(grSigProj, "grSigProj");
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    TString sIndex("_");
+    sIndex += iSig;
+    dCache -> WriteTObject(grMuHiProj[iSig], "grMuHi" + sIndex);
+    dCache -> WriteTObject(grMuLoProj[iSig], "grMuLo" + sIndex);
+    dCache -> WriteTObject(fMuHiProj[iSig],  "fMuHi" + sIndex);
+    dCache -> WriteTObject(fMuLoProj[iSig],  "fMuLo" + sIndex);
+  }
+
+  // projection means & widths
+  const TVectorD tvecMuProj(muProj.size(), muProj.data());
+  const TVectorD tvecSigProj(sigProj.size(), sigProj.data());
+  dCache -> WriteTObject(&tvecMuProj,  "muProj");
+  dCache -> WriteTObject(&tvecSigProj, "sigProj");
+
+  fCache  -> Close();
+  fOutput -> cd();
+
+  cout << "      Wrote sigma graphs and bands to calibration cache (" << sKey.Data() << ")." << endl;
+  return;
+
+}  // end 'WriteCalibrationCache()'
+
+
+
+TString SDeltaPtCutStudy::GetCalibrationKey() {
+
+  // identify input by path, size, modification time, & no. of tracks
+  FileStat_t stat;
+  gSystem -> GetPathInfo(sInFile.Data(), stat);
+
+  // collect everything the sigma graphs & bands depend on
+  ostringstream config;
+  config << setprecision(17)
+         << sInFile.Data()  << " " << stat.fSize   << " " << stat.fMtime << " " << nTrks << " "
+         << sInTrack.Data() << " " << nInttTrkMin  << " " << nMVtxTrkMin << " " << nTpcTrkMin << " "
+         << qualTrkMax      << " " << vzTrkMax     << " " << ptTrkMin    << " "
+         << axPt.nBins      << " " << axPt.xMin    << " " << axPt.xMax   << " "
+         << axDelta.nBins   << " " << axDelta.xMin << " " << axDelta.xMax << " "
+         << ptProjWidth     << " " << doFastSlices << " " << nSliceSigTrunc << " " << nSliceMaxIter << " "
+         << doDenseSlices   << " " << nDenseMinEntries << " " << nDenseMaxGroup << " " << doQuantileBands << " "
+         << doUnbinnedFit   << " " << sCutExpr.Data() << " "
+         << doSectorMask    << " " << maskWidth   << " ";
+  for (const double boundary : maskBoundaries) {
+    config << boundary << " ";
+  }
+  for (size_t iPar = 0; iPar < Const::NPar; iPar++) {
+    config << sigHiGuess[iPar] << " " << sigLoGuess[iPar] << " ";
+  }
+  for (size_t iRange = 0; iRange < Const::NRange; iRange++) {
+    config << ptFitRange[iRange] << " " << deltaFitRange[iRange] << " " << rPtRange[iRange] << " ";
+  }
+  for (size_t iProj = 0; iProj < nProj; iProj++) {
+    config << ptProj[iProj] << " " << sPtProj[iProj].Data() << " ";
+  }
+  for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
+    config << ptDeltaSig[iSig] << " " << sSigSuffix[iSig].Data() << " ";
+  }
+
+  return HashConfig("calib_", config.str());
+
+}  // end 'GetCalibrationKey()'
+
+
+
+TString SDeltaPtCutStudy::HashConfig(const TString& sPrefix, const string& config) {
+
+  // 64-bit FNV-1a hash
+  uint64_t hash = 14695981039346656037ULL;
+  for (const char character : config) {
+    hash ^= (unsigned char) character;
+    hash *= 1099511628211ULL;
+  }
+
+  ostringstream key;
+  key << sPrefix.Data() << hex << setw(16) << setfill('0') << hash;
+  return TString(key.str());
+
+}  // end 'HashConfig(TString&, string&)'
+
 // end ------------------------------------------------------------------------
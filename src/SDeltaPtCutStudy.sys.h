@@ -299,15 +299,38 @@ void SDeltaPtCutStudy::InitTuples() {
 
 
 
-void SDeltaPtCutStudy::InitHists() {
+void SDeltaPtCutStudy::InitCutExpression() {
+
+  if (!doCutExpr) return;
+
+  // parse & compile expression
+  string sError;
+  if (!cutExpr.Parse(sCutExpr.Data(), sError)) {
+    cerr << "PANIC: couldn't parse cut expression!\n"
+         << "       " << sError
+         << endl;
+    assert(false);
+  }
 
-  // histogram binning
-  const uint64_t nPtBins(1000);
-  const uint64_t nFracBins(1000);
-  const uint64_t nDeltaBins(5000);
-  const float    rPtBins[Const::NRange]    = {0., 100.};
-  const float    rFracBins[Const::NRange]  = {0., 10.};
-  const float    rDeltaBins[Const::NRange] = {0., 5.};
+  // find (already bound) address of each referenced column
+  exprAddresses.clear();
+  for (const string& column : cutExpr.GetColumns()) {
+    TBranch* branch = ntTrack -> GetBranch(column.c_str());
+    if (!branch) {
+      cerr << "PANIC: cut expression uses column '" << column << "', which isn't in the track tuple!" << endl;
+      assert(branch);
+    }
+    exprAddresses.push_back((float*) branch -> GetAddress());
+  }
+
+  cout << "    Initialized cut expression: " << cutExpr.GetColumns().size() << " columns referenced." << endl;
+  return;
+
+}  // end 'InitCutExpression()'
+
+
+
+void SDeltaPtCutStudy::InitHists() {
 
   // create names
   TString sPtTruth("h");
@@ -464,46 +487,190 @@ void SDeltaPtCutStudy::InitHists() {
     hPtDeltaProj[iProj] -> Sumw2();
   }
 
-  // flat delta-pt cut histograms
+  // cut-variant histograms are created when their engines are
+  // exported, so only keep their names (no-cut is the last flat slot)
+  sFlatCutNames.assign(Hist::NHist, vector<TString>(nDPtCuts + 1));
   for (size_t iCut = 0; iCut < nDPtCuts; iCut++) {
-    hPtDeltaCut[iCut]  = new TH1D(sPtDeltaCut[iCut].Data(),  "", nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
-    hPtTrackCut[iCut]  = new TH1D(sPtTrackCut[iCut].Data(),  "", nPtBins,    rPtBins[0],    rPtBins[1]);
-    hPtFracCut[iCut]   = new TH1D(sPtFracCut[iCut].Data(),   "", nFracBins,  rFracBins[0],  rFracBins[1]);
-    hPtTrkTruCut[iCut] = new TH1D(sPtTrkTruCut[iCut].Data(), "", nPtBins,    rPtBins[0],    rPtBins[1]);
-    hPtDeltaCut[iCut]  -> Sumw2();
-    hPtTrackCut[iCut]  -> Sumw2();
-    hPtFracCut[iCut]   -> Sumw2();
-    hPtTrkTruCut[iCut] -> Sumw2();
-
-    hPtDeltaVsFracCut[iCut]  = new TH2D(sPtDeltaVsFracCut[iCut].Data(),  "", nFracBins, rFracBins[0], rFracBins[1], nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
-    hPtDeltaVsTrueCut[iCut]  = new TH2D(sPtDeltaVsTrueCut[iCut].Data(),  "", nPtBins,   rPtBins[0],   rPtBins[1],   nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
-    hPtDeltaVsTrackCut[iCut] = new TH2D(sPtDeltaVsTrackCut[iCut].Data(), "", nPtBins,   rPtBins[0],   rPtBins[1],   nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
-    hPtTrueVsTrackCut[iCut]  = new TH2D(sPtTrueVsTrackCut[iCut].Data(),  "", nPtBins,   rPtBins[0],   rPtBins[1],   nPtBins,    rPtBins[0],    rPtBins[1]);
-    hPtDeltaVsFracCut[iCut]  -> Sumw2();
-    hPtDeltaVsTrueCut[iCut]  -> Sumw2();
-    hPtDeltaVsTrackCut[iCut] -> Sumw2();
-    hPtTrueVsTrackCut[iCut]  -> Sumw2();
+    sFlatCutNames[Hist::HDelta][iCut]        = sPtDeltaCut[iCut];
+    sFlatCutNames[Hist::HTrack][iCut]        = sPtTrackCut[iCut];
+    sFlatCutNames[Hist::HFrac][iCut]         = sPtFracCut[iCut];
+    sFlatCutNames[Hist::HTrkTru][iCut]       = sPtTrkTruCut[iCut];
+    sFlatCutNames[Hist::HDeltaVsFrac][iCut]  = sPtDeltaVsFracCut[iCut];
+    sFlatCutNames[Hist::HDeltaVsTrue][iCut]  = sPtDeltaVsTrueCut[iCut];
+    sFlatCutNames[Hist::HDeltaVsTrack][iCut] = sPtDeltaVsTrackCut[iCut];
+    sFlatCutNames[Hist::HTrueVsTrack][iCut]  = sPtTrueVsTrackCut[iCut];
   }
-
-  // pt-dependent delta-pt cut histograms
+  sFlatCutNames[Hist::HDelta][nDPtCuts]        = sPtDelta;
+  sFlatCutNames[Hist::HTrack][nDPtCuts]        = sPtTrack;
+  sFlatCutNames[Hist::HFrac][nDPtCuts]         = sPtFrac;
+  sFlatCutNames[Hist::HTrkTru][nDPtCuts]       = sPtTrkTru;
+  sFlatCutNames[Hist::HDeltaVsFrac][nDPtCuts]  = sPtDeltaVsFrac;
+  sFlatCutNames[Hist::HDeltaVsTrue][nDPtCuts]  = sPtDeltaVsTrue;
+  sFlatCutNames[Hist::HDeltaVsTrack][nDPtCuts] = sPtDeltaVsTrack;
+  sFlatCutNames[Hist::HTrueVsTrack][nDPtCuts]  = sPtTrueVsTrack;
+
+  sSigmaCutNames.assign(Hist::NHist, vector<TString>(nSigCuts));
   for (size_t iSig = 0; iSig < nSigCuts; iSig++) {
-    hPtDeltaSig[iSig]  = new TH1D(sPtDeltaSig[iSig].Data(),  "", nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
-    hPtTrackSig[iSig]  = new TH1D(sPtTrackSig[iSig].Data(),  "", nPtBins,    rPtBins[0],    rPtBins[1]);
-    hPtFracSig[iSig]   = new TH1D(sPtFracSig[iSig].Data(),   "", nFracBins,  rFracBins[0],  rFracBins[1]);
-    hPtTrkTruSig[iSig] = new TH1D(sPtTrkTruSig[iSig].Data(), "", nPtBins,    rPtBins[0],    rPtBins[1]);
-    hPtDeltaSig[iSig]  -> Sumw2();
-    hPtTrackSig[iSig]  -> Sumw2();
-    hPtFracSig[iSig]   -> Sumw2();
-    hPtTrkTruSig[iSig] -> Sumw2();
-
-    hPtDeltaVsFracSig[iSig]  = new TH2D(sPtDeltaVsFracSig[iSig].Data(),  "", nFracBins, rFracBins[0], rFracBins[1], nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
-    hPtDeltaVsTrueSig[iSig]  = new TH2D(sPtDeltaVsTrueSig[iSig].Data(),  "", nPtBins,   rPtBins[0],   rPtBins[1],   nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
-    hPtDeltaVsTrackSig[iSig] = new TH2D(sPtDeltaVsTrackSig[iSig].Data(), "", nPtBins,   rPtBins[0],   rPtBins[1],   nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
-    hPtTrueVsTrackSig[iSig]  = new TH2D(sPtTrueVsTrackSig[iSig].Data(),  "", nPtBins,   rPtBins[0],   rPtBins[1],   nPtBins,    rPtBins[0],    rPtBins[1]);
-    hPtDeltaVsFracSig[iSig]  -> Sumw2();
-    hPtDeltaVsTrueSig[iSig]  -> Sumw2();
-    hPtDeltaVsTrackSig[iSig] -> Sumw2();
-    hPtTrueVsTrackSig[iSig]  -> Sumw2();
+    sSigmaCutNames[Hist::HDelta][iSig]        = sPtDeltaSig[iSig];
+    sSigmaCutNames[Hist::HTrack][iSig]        = sPtTrackSig[iSig];
+    sSigmaCutNames[Hist::HFrac][iSig]         = sPtFracSig[iSig];
+    sSigmaCutNames[Hist::HTrkTru][iSig]       = sPtTrkTruSig[iSig];
+    sSigmaCutNames[Hist::HDeltaVsFrac][iSig]  = sPtDeltaVsFracSig[iSig];
+    sSigmaCutNames[Hist::HDeltaVsTrue][iSig]  = sPtDeltaVsTrueSig[iSig];
+    sSigmaCutNames[Hist::HDeltaVsTrack][iSig] = sPtDeltaVsTrackSig[iSig];
+    sSigmaCutNames[Hist::HTrueVsTrack][iSig]  = sPtTrueVsTrackSig[iSig];
+  }
+
+  // shared axes and fill engines for track histograms
+  //   (the extra flat-cut slot holds the no-cut histograms,
+  //   & pt-dependent engines are made when the 2nd loop starts)
+  axPt    = SVariantAxis(nPtBins,    rPtBins[0],    rPtBins[1]);
+  axFrac  = SVariantAxis(nFracBins,  rFracBins[0],  rFracBins[1]);
+  axDelta = SVariantAxis(nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
+
+  vhPtCut.resize(Hist::NHist);
+  vhPtCut[Hist::HDelta]        = SVariantHist(nDPtCuts + 1, axDelta);
+  vhPtCut[Hist::HTrack]        = SVariantHist(nDPtCuts + 1, axPt);
+  vhPtCut[Hist::HFrac]         = SVariantHist(nDPtCuts + 1, axFrac);
+  vhPtCut[Hist::HTrkTru]       = SVariantHist(nDPtCuts + 1, axPt);
+  vhPtCut[Hist::HDeltaVsFrac]  = SVariantHist(nDPtCuts + 1, axFrac, axDelta);
+  vhPtCut[Hist::HDeltaVsTrue]  = SVariantHist(nDPtCuts + 1, axPt,   axDelta);
+  vhPtCut[Hist::HDeltaVsTrack] = SVariantHist(nDPtCuts + 1, axPt,   axDelta);
+  vhPtCut[Hist::HTrueVsTrack]  = SVariantHist(nDPtCuts + 1, axPt,   axPt);
+
+  // fill buffer columns and the columns each engine is filled with
+  axFillCols.resize(Col::NCol);
+  axFillCols[Col::CDelta]  = axDelta;
+  axFillCols[Col::CTrack]  = axPt;
+  axFillCols[Col::CFrac]   = axFrac;
+  axFillCols[Col::CTrkTru] = axPt;
+
+  vhFillCols.resize(Hist::NHist);
+  vhFillCols[Hist::HDelta]        = make_pair(Col::CDelta,  -1);
+  vhFillCols[Hist::HTrack]        = make_pair(Col::CTrack,  -1);
+  vhFillCols[Hist::HFrac]         = make_pair(Col::CFrac,   -1);
+  vhFillCols[Hist::HTrkTru]       = make_pair(Col::CTrkTru, -1);
+  vhFillCols[Hist::HDeltaVsFrac]  = make_pair(Col::CFrac,   Col::CDelta);
+  vhFillCols[Hist::HDeltaVsTrue]  = make_pair(Col::CTrkTru, Col::CDelta);
+  vhFillCols[Hist::HDeltaVsTrack] = make_pair(Col::CTrack,  Col::CDelta);
+  vhFillCols[Hist::HTrueVsTrack]  = make_pair(Col::CTrack,  Col::CTrkTru);
+
+  // cut decisions are tracked in 64-bit masks
+  const size_t nMaxVariants = 64;
+  if (((nDPtCuts + 1) > nMaxVariants) || (nSigCuts > nMaxVariants)) {
+    cerr << "PANIC: too many cuts! At most " << (nMaxVariants - 1) << " flat and " << nMaxVariants << " pt-dependent cuts are allowed.\n"
+         << "       nDPtCuts = " << nDPtCuts << ", nSigCuts = " << nSigCuts
+         << endl;
+    assert(((nDPtCuts + 1) <= nMaxVariants) && (nSigCuts <= nMaxVariants));
+  }
+
+  // deferred filling requires the track store
+  if (doDeferHists && !doTrackStore) {
+    cerr << "WARNING: deferred filling requires the track store! Turning track store on." << endl;
+    doTrackStore = true;
+  }
+
+  // rebuilding never reads the track tuple, so only what
+  // can be made from the stored tracks & decisions is kept
+  if (doRebuildHists) {
+    if (!doTrackStore) {
+      cerr << "WARNING: rebuilding requires the track store! Turning track store on." << endl;
+      doTrackStore = true;
+    }
+    if (doCkpt) {
+      cerr << "WARNING: rebuilding isn't checkpointed! Turning checkpoints off." << endl;
+      doCkpt = false;
+    }
+    if (doCutScan || doTruthMatch || doRocSurface || doBootstrap) {
+      cerr << "WARNING: rebuilding from track store! Turning off general cut scan, truth matching, ROC surface, and bootstrap." << endl;
+      doCutScan    = false;
+      doTruthMatch = false;
+      doRocSurface = false;
+      doBootstrap  = false;
+    }
+    doCutExpr    = false;
+    doDeferHists = false;
+  }
+
+  // sector mask lookup & with-vs-without mask output
+  if (doSectorMask) {
+    sectorMask.Init(maskBoundaries.empty() ? SSectorMask::GetDefaultBoundaries() : maskBoundaries, maskWidth);
+    nNormNoMask.assign(nDPtCuts, 0);
+    nWeirdNoMask.assign(nDPtCuts, 0);
+    hPtDeltaNoMask   = new TH1D("hPtDeltaNoMask",   "", nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
+    hPtDeltaWithMask = new TH1D("hPtDeltaWithMask", "", nDeltaBins, rDeltaBins[0], rDeltaBins[1]);
+    hSectorDistance  = new TH1D("hSectorDistance",  "", 500, 0., sectorMask.GetMaxDistance());
+    hPtDeltaNoMask   -> Sumw2();
+    hPtDeltaWithMask -> Sumw2();
+    hSectorDistance  -> Sumw2();
+    cout << "      Initialized sector mask: " << sectorMask.GetNBoundaries() << " boundaries, width = " << sectorMask.GetWidth() << "." << endl;
+  }
+
+  // cut flow over general cuts (& sector mask & cut expression if used)
+  vector<TString> sFlowCuts = {"zvtx", "intt", "mvtx", "tpc", "pt", "quality"};
+  if (doSectorMask) {
+    bitSector = 1U << sFlowCuts.size();
+    sFlowCuts.push_back("sector");
+  }
+  if (doCutExpr) {
+    bitExpr = 1U << sFlowCuts.size();
+    sFlowCuts.push_back("expr");
+  }
+  cutFlow.Init(sFlowCuts);
+
+  // bootstrap replicas of the rejection & efficiency counters
+  if (doBootstrap) {
+    boot.Init(nBootReps, (2 * nDPtCuts) + (2 * nSigCuts) + 1, bootSeed);
+    cout << "      Initialized bootstrap: " << nBootReps << " replicas of " << boot.GetNCounters() << " counters." << endl;
+  }
+
+  // truth-matching counters (flat cuts & no cut)
+  if (doTruthMatch) {
+    nMatchTrk.assign(nDPtCuts + 1, 0);
+    nSecondTrk.assign(nDPtCuts + 1, 0);
+    nFakeTrk.assign(nDPtCuts + 1, 0);
+  }
+
+  // binning of roc cubes
+  if (doRocSurface) {
+    vector<SVariantAxis> axRoc = {
+      SVariantAxis(20, 0.,  0.2),
+      SVariantAxis(20, 0.,  5.),
+      SVariantAxis(10, 0.,  20.),
+      SVariantAxis(10, 0.,  50.),
+      SVariantAxis(5,  0.,  5.)
+    };
+    if (rocAxisParams.size() == Roc::NRoc) {
+      for (size_t iRoc = 0; iRoc < Roc::NRoc; iRoc++) {
+        axRoc[iRoc] = SVariantAxis(get<0>(rocAxisParams[iRoc]), get<1>(rocAxisParams[iRoc]), get<2>(rocAxisParams[iRoc]));
+      }
+    } else if (!rocAxisParams.empty()) {
+      cerr << "WARNING: need " << Roc::NRoc << " roc axes but got " << rocAxisParams.size() << "! Using default binning." << endl;
+    }
+    cubeNorm.Init(axRoc);
+    cubeWeird.Init(axRoc);
+  }
+
+  // scan grids default to the nominal general cuts
+  if (doCutScan) {
+    const double nominal[SCutScan::Cut::NCut] = {(double) nInttTrkMin, (double) nMVtxTrkMin, (double) nTpcTrkMin, qualTrkMax, vzTrkMax, ptTrkMin};
+    for (size_t iCut = 0; iCut < SCutScan::Cut::NCut; iCut++) {
+      if (scanGrids[iCut].empty()) scanGrids[iCut].push_back(nominal[iCut]);
+    }
+    cutScan.Init(scanGrids, nDPtCuts + 1, SVariantAxis(nScanPtBins, axPt.xMin, axPt.xMax));
+    cout << "      Initialized general cut scan: " << cutScan.GetNPoints() << " grid points." << endl;
+  }
+
+  // track grouping runs over the track store
+  if (doTrackGroups && !doTrackStore) {
+    cerr << "WARNING: track grouping requires the track store! Turning track store on." << endl;
+    doTrackStore = true;
+  }
+
+  // unbinned fit runs over the track store
+  if (doUnbinnedFit && !doTrackStore) {
+    cerr << "WARNING: unbinned resolution fit requires the track store! Turning track store on." << endl;
+    doTrackStore = true;
   }
 
   cout << "      Initialized output histograms." << endl;
@@ -511,4 +678,22 @@ void SDeltaPtCutStudy::InitHists() {
 
 }  // end 'InitHists()'
 
+
+
+void SDeltaPtCutStudy::InitSigmaEngines() {
+
+  // only needed once the flat-cut engines are exported
+  vhPtSig.resize(Hist::NHist);
+  vhPtSig[Hist::HDelta]        = SVariantHist(nSigCuts, axDelta);
+  vhPtSig[Hist::HTrack]        = SVariantHist(nSigCuts, axPt);
+  vhPtSig[Hist::HFrac]         = SVariantHist(nSigCuts, axFrac);
+  vhPtSig[Hist::HTrkTru]       = SVariantHist(nSigCuts, axPt);
+  vhPtSig[Hist::HDeltaVsFrac]  = SVariantHist(nSigCuts, axFrac, axDelta);
+  vhPtSig[Hist::HDeltaVsTrue]  = SVariantHist(nSigCuts, axPt,   axDelta);
+  vhPtSig[Hist::HDeltaVsTrack] = SVariantHist(nSigCuts, axPt,   axDelta);
+  vhPtSig[Hist::HTrueVsTrack]  = SVariantHist(nSigCuts, axPt,   axPt);
+  return;
+
+}  // end 'InitSigmaEngines()'
+
 // end ------------------------------------------------------------------------
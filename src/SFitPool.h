@@ -0,0 +1,233 @@
+// ----------------------------------------------------------------------------
+// 'SFitPool.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Minimal pool for running independent
+// fits concurrently. Jobs are indexed,
+// and each job writes its result into
+// its own slot, so results come out in
+// the same order regardless of which
+// thread ran which job. Workers are
+// started once & kept for the lifetime
+// of the pool, so a pool can be reused
+// for many small batches. 'SFitMinimizer'
+// picks the minimizer for a block of fits
+// & puts the previous default back after.
+// ----------------------------------------------------------------------------
+
+#ifndef SFITPOOL_H
+#define SFITPOOL_H
+
+// standard c includes
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+// root includes
+#include <TROOT.h>
+#include <Math/MinimizerOptions.h>
+
+using namespace std;
+
+
+
+// SFitPool definition --------------------------------------------------------
+
+class SFitPool {
+
+  public:
+
+    // ctor (0 = one thread per core) & dtor
+    SFitPool(const size_t nThread = 0);
+    ~SFitPool();
+
+    // workers can't be shared between copies
+    SFitPool(const SFitPool&)            = delete;
+    SFitPool& operator=(const SFitPool&) = delete;
+
+    // run job(iJob) for iJob in [0, nJobs), with the calling
+    // thread helping out; one batch at a time per pool
+    void Run(const size_t nJobs, const function<void(size_t)>& job) const;
+
+    // make ROOT safe to use from several threads: objects
+    // must still be created outside the jobs, and fits need
+    // Minuit2 (see 'SFitMinimizer') as TMinuit keeps global state
+    static void EnableThreadSafeFits();
+
+    // getters
+    size_t GetNThreads() const {return nThreads;}
+
+  private:
+
+    // worker: wait for a batch, pull its jobs, & report back
+    void Work();
+
+    // parameters & persistent workers (the caller is the last thread)
+    size_t         nThreads = 1;
+    vector<thread> workers;
+
+    // current batch: 'iBatch' counts batches so workers
+    // can tell a new one from a spurious wake-up
+    mutable mutex                          lock;
+    mutable condition_variable             wake;
+    mutable condition_variable             done;
+    mutable const function<void(size_t)>*  batchJob   = NULL;
+    mutable size_t                         batchSize  = 0;
+    mutable size_t                         nBusy      = 0;
+    mutable uint64_t                       iBatch     = 0;
+    mutable atomic<size_t>                 iNext;
+    bool                                   isStopping = false;
+
+};  // end SFitPool definition
+
+
+
+// SFitMinimizer definition ---------------------------------------------------
+
+class SFitMinimizer {
+
+  public:
+
+    // set default minimizer while in scope
+    SFitMinimizer(const char* type = "Minuit2", const char* algo = "Migrad");
+    ~SFitMinimizer();
+
+    // restoring twice would be wrong
+    SFitMinimizer(const SFitMinimizer&)            = delete;
+    SFitMinimizer& operator=(const SFitMinimizer&) = delete;
+
+  private:
+
+    // default before construction
+    string prevType;
+    string prevAlgo;
+
+};  // end SFitMinimizer definition
+
+
+
+// SFitPool implementation ----------------------------------------------------
+
+inline SFitPool::SFitPool(const size_t nThread) {
+
+  nThreads = (nThread > 0) ? nThread : thread::hardware_concurrency();
+  if (nThreads == 0) nThreads = 1;
+
+  iNext = 0;
+  for (size_t iWorker = 1; iWorker < nThreads; iWorker++) {
+    workers.emplace_back(&SFitPool::Work, this);
+  }
+
+}  // end ctor(size_t)
+
+
+
+inline SFitPool::~SFitPool() {
+
+  {
+    lock_guard<mutex> guard(lock);
+    isStopping = true;
+  }
+  wake.notify_all();
+  for (thread& worker : workers) {
+    worker.join();
+  }
+
+}  // end dtor
+
+
+
+inline void SFitPool::Run(const size_t nJobs, const function<void(size_t)>& job) const {
+
+  // run serially if there's nothing to gain
+  if (workers.empty() || (nJobs <= 1)) {
+    for (size_t iJob = 0; iJob < nJobs; iJob++) {
+      job(iJob);
+    }
+    return;
+  }
+
+  // hand batch to workers
+  {
+    lock_guard<mutex> guard(lock);
+    batchJob  = &job;
+    batchSize = nJobs;
+    nBusy     = workers.size();
+    iNext     = 0;
+    ++iBatch;
+  }
+  wake.notify_all();
+
+  // pull jobs here too, then wait for the rest
+  for (size_t iJob = iNext++; iJob < nJobs; iJob = iNext++) {
+    job(iJob);
+  }
+
+  unique_lock<mutex> guard(lock);
+  done.wait(guard, [this]() {return (nBusy == 0);});
+  batchJob = NULL;
+  return;
+
+}  // end 'Run(size_t, function<void(size_t)>&)'
+
+
+
+inline void SFitPool::Work() {
+
+  uint64_t iSeen = 0;
+  while (true) {
+    unique_lock<mutex> guard(lock);
+    wake.wait(guard, [&]() {return (isStopping || (iBatch != iSeen));});
+    if (isStopping) return;
+
+    iSeen = iBatch;
+    const function<void(size_t)>* job   = batchJob;
+    const size_t                  nJobs = batchSize;
+    guard.unlock();
+
+    for (size_t iJob = iNext++; iJob < nJobs; iJob = iNext++) {
+      (*job)(iJob);
+    }
+
+    guard.lock();
+    if (--nBusy == 0) done.notify_one();
+  }
+
+}  // end 'Work()'
+
+
+
+inline void SFitPool::EnableThreadSafeFits() {
+
+  ROOT::EnableThreadSafety();
+  return;
+
+}  // end 'EnableThreadSafeFits()'
+
+
+
+// SFitMinimizer implementation -----------------------------------------------
+
+inline SFitMinimizer::SFitMinimizer(const char* type, const char* algo) {
+
+  prevType = ROOT::Math::MinimizerOptions::DefaultMinimizerType();
+  prevAlgo = ROOT::Math::MinimizerOptions::DefaultMinimizerAlgo();
+  ROOT::Math::MinimizerOptions::SetDefaultMinimizer(type, algo);
+
+}  // end ctor(char*, char*)
+
+
+
+inline SFitMinimizer::~SFitMinimizer() {
+
+  ROOT::Math::MinimizerOptions::SetDefaultMinimizer(prevType.data(), prevAlgo.data());
+
+}  // end dtor
+
+#endif
+
+// end ------------------------------------------------------------------------
@@ -0,0 +1,134 @@
+// ----------------------------------------------------------------------------
+// 'SFitRecord.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Diagnostics of a single fit (or fast
+// estimate) made by 'SDeltaPtCutStudy':
+// what was fit, whether it converged, its
+// goodness-of-fit, parameter errors, and
+// how long it took. Records are collected
+// per run and written out as a tree.
+// ----------------------------------------------------------------------------
+
+#ifndef SFITRECORD_H
+#define SFITRECORD_H
+
+// standard c includes
+#include <chrono>
+#include <vector>
+#include <cstdint>
+// root includes
+#include <TF1.h>
+#include <TTree.h>
+#include <TString.h>
+#include <TFitResult.h>
+#include <TFitResultPtr.h>
+
+using namespace std;
+
+
+
+// SFitRecord definition ------------------------------------------------------
+
+struct SFitRecord {
+
+  // what was fit
+  enum Kind {Slice, Estimate, Dense, Band, Unbinned};
+
+  // kind, index within kind, & pt of slice (or
+  // signed no. of sigma of band)
+  int32_t kind  = Kind::Slice;
+  int32_t index = 0;
+  double  x     = 0.;
+
+  // status (0 = ok), chi2 (-ln(L) for unbinned
+  // fits), ndf, & no. of function calls (no. of
+  // iterations for estimates)
+  int32_t status = 0;
+  double  chi2   = 0.;
+  int32_t ndf    = 0;
+  int32_t nCalls = 0;
+
+  // parameter errors & wall time in ms
+  vector<double> parErr;
+  double         time = 0.;
+
+  // start the clock
+  inline void Start() {start = chrono::steady_clock::now();}
+
+  // stop the clock & pick up status, chi2, etc. of a fit
+  void Stop();
+  void Stop(const TFitResultPtr& result, const TF1* function);
+
+  private:
+
+    chrono::steady_clock::time_point start;
+
+};  // end SFitRecord definition
+
+
+
+// SFitRecord implementation --------------------------------------------------
+
+inline void SFitRecord::Stop() {
+
+  time = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+  return;
+
+}  // end 'Stop()'
+
+
+
+inline void SFitRecord::Stop(const TFitResultPtr& result, const TF1* function) {
+
+  Stop();
+  status = (int) result;
+  chi2   = function -> GetChisquare();
+  ndf    = function -> GetNDF();
+  nCalls = result.Get() ? result -> NCalls() : 0;
+
+  parErr.resize(function -> GetNpar());
+  for (size_t iPar = 0; iPar < parErr.size(); iPar++) {
+    parErr[iPar] = function -> GetParError(iPar);
+  }
+  return;
+
+}  // end 'Stop(TFitResultPtr&, TF1*)'
+
+
+
+// output ---------------------------------------------------------------------
+
+// write records into a tree in the current directory
+inline TTree* MakeFitRecordTree(const vector<SFitRecord>& records, const TString sName) {
+
+  // tree addresses
+  SFitRecord      record;
+  vector<double>* parErr = &record.parErr;
+
+  TTree* tree = new TTree(sName.Data(), "fit diagnostics from SDeltaPtCutStudy");
+  tree -> Branch("kind",   &record.kind,   "kind/I");
+  tree -> Branch("index",  &record.index,  "index/I");
+  tree -> Branch("x",      &record.x,      "x/D");
+  tree -> Branch("status", &record.status, "status/I");
+  tree -> Branch("chi2",   &record.chi2,   "chi2/D");
+  tree -> Branch("ndf",    &record.ndf,    "ndf/I");
+  tree -> Branch("nCalls", &record.nCalls, "nCalls/I");
+  tree -> Branch("time",   &record.time,   "time/D");
+  tree -> Branch("parErr", &parErr);
+
+  for (const SFitRecord& fit : records) {
+    record = fit;
+    tree -> Fill();
+  }
+
+  // addresses point at locals, so don't leave them behind
+  tree -> ResetBranchAddresses();
+  return tree;
+
+}  // end 'MakeFitRecordTree(vector<SFitRecord>&, TString)'
+
+#endif
+
+// end ------------------------------------------------------------------------
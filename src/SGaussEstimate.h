@@ -0,0 +1,121 @@
+// ----------------------------------------------------------------------------
+// 'SGaussEstimate.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Fast estimate of the mean & width of
+// a gaussian peak directly from binned
+// contents via an iterative, truncation-
+// corrected mean/RMS. Meant as a cheap
+// alternative to a Minuit fit of each
+// delta-pt slice in 'SDeltaPtCutStudy'.
+// ----------------------------------------------------------------------------
+
+#ifndef SGAUSSESTIMATE_H
+#define SGAUSSESTIMATE_H
+
+// standard c includes
+#include <cmath>
+#include <cstdint>
+// user includes
+#include "SVariantHist.h"
+
+using namespace std;
+
+
+
+// SGaussEstimate definition --------------------------------------------------
+
+struct SGaussEstimate {
+
+  // same meaning as the parameters of TF1("gaus")
+  double amp   = 0.;
+  double mu    = 0.;
+  double sigma = 0.;
+
+  // sum of contents used & no. of iterations
+  double sum    = 0.;
+  size_t nIter  = 0;
+  bool   isGood = false;
+
+};  // end SGaussEstimate definition
+
+
+
+// estimator ------------------------------------------------------------------
+
+// contents[iBin * stride] is the content of bin iBin + 1 of axis,
+// so both a TH1D (stride = 1) and a column of a TH2D (stride =
+// nBinsX + 2) can be used in-place. Starts from the mean & RMS in
+// [loInit, hiInit], then iterates on [mu - nSigTrunc * sigma,
+// mu + nSigTrunc * sigma], correcting the RMS for the truncation
+// and for the bin width.
+inline SGaussEstimate EstimateGauss(const double* contents, const size_t stride, const SVariantAxis& axis, const double loInit, const double hiInit, const double nSigTrunc = 2., const size_t nMaxIter = 20) {
+
+  const double tolerance = 1e-4;
+  const double width     = (axis.xMax - axis.xMin) / axis.nBins;
+
+  // fraction & variance of a unit gaussian within +-nSigTrunc
+  const double fracTrunc = erf(nSigTrunc / sqrt(2.));
+  const double varTrunc  = 1. - ((2. * nSigTrunc * exp(-0.5 * nSigTrunc * nSigTrunc)) / (sqrt(2. * M_PI) * fracTrunc));
+
+  // get sum, mean, & variance of bins with centers in [lo, hi]
+  auto getMoments = [&](const double lo, const double hi, double& sum, double& mean, double& var) {
+    const uint32_t iStart = max(axis.FindBin(lo), (uint32_t) 1);
+    const uint32_t iStop  = min(axis.FindBin(hi), axis.nBins);
+
+    double sumX  = 0.;
+    double sumX2 = 0.;
+    sum = 0.;
+    for (uint32_t iBin = iStart; iBin <= iStop; iBin++) {
+      const double center = axis.xMin + ((iBin - 0.5) * width);
+      if ((center < lo) || (center > hi)) continue;
+
+      const double content = contents[(iBin - 1) * stride];
+      sum   += content;
+      sumX  += content * center;
+      sumX2 += content * center * center;
+    }
+    mean = (sum > 0.) ? (sumX / sum) : 0.;
+    var  = (sum > 0.) ? ((sumX2 / sum) - (mean * mean)) : 0.;
+  };  // end 'getMoments(double, double, double&, double&, double&)'
+
+  // starting point
+  SGaussEstimate estimate;
+  double         sum;
+  double         mean;
+  double         var;
+  getMoments(loInit, hiInit, sum, mean, var);
+  if ((sum <= 0.) || (var <= 0.)) return estimate;
+
+  estimate.mu    = mean;
+  estimate.sigma = sqrt(var);
+  estimate.sum   = sum;
+
+  // iterate on truncated window
+  for (size_t iIter = 0; iIter < nMaxIter; iIter++) {
+    getMoments(estimate.mu - (nSigTrunc * estimate.sigma), estimate.mu + (nSigTrunc * estimate.sigma), sum, mean, var);
+    if ((sum <= 0.) || (var <= 0.)) break;
+
+    // correct for bin width, then truncation
+    const double varBinned = var - ((width * width) / 12.);
+    const double sigma     = sqrt(((varBinned > 0.) ? varBinned : var) / varTrunc);
+    const bool   isDone    = ((abs(mean - estimate.mu) < (tolerance * sigma)) && (abs(sigma - estimate.sigma) < (tolerance * sigma)));
+
+    estimate.mu    = mean;
+    estimate.sigma = sigma;
+    estimate.sum   = sum;
+    estimate.nIter = iIter + 1;
+    if (isDone) break;
+  }
+
+  // peak height of a gaussian with the same area
+  estimate.amp    = ((estimate.sum / fracTrunc) * width) / (sqrt(2. * M_PI) * estimate.sigma);
+  estimate.isGood = (estimate.nIter > 0);
+  return estimate;
+
+}  // end 'EstimateGauss(double*, size_t, SVariantAxis&, double, double, double, size_t)'
+
+#endif
+
+// end ------------------------------------------------------------------------
@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------------
+// 'SPrefixSum.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Summed-area table over the contents of
+// a 2D histogram. Built once, it answers
+// any rectangular integral in O(1) and
+// reads out a y-slice over any range of
+// x bins in O(nBinsY), without rescanning
+// the histogram.
+// ----------------------------------------------------------------------------
+
+#ifndef SPREFIXSUM_H
+#define SPREFIXSUM_H
+
+// standard c includes
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+
+
+// SPrefixSum2D definition ----------------------------------------------------
+
+class SPrefixSum2D {
+
+  public:
+
+    // ctor
+    SPrefixSum2D() {}
+
+    // build from a TH2-style array ([y][x], incl. under/overflow)
+    void Build(const double* contents, const uint32_t nBinsX, const uint32_t nBinsY);
+
+    // sum of bins in [ixLo, ixHi] x [iyLo, iyHi] (same numbering as TH2)
+    inline double Integral(const uint32_t ixLo, const uint32_t ixHi, const uint32_t iyLo, const uint32_t iyHi) const {
+      return At(ixHi, iyHi) - At((int64_t) ixLo - 1, iyHi) - At(ixHi, (int64_t) iyLo - 1) + At((int64_t) ixLo - 1, (int64_t) iyLo - 1);
+    }
+
+    // slice[iy - 1] = sum of bins [ixLo, ixHi] in y bin iy, for iy = 1...nBinsY
+    void GetSliceY(const uint32_t ixLo, const uint32_t ixHi, double* slice) const;
+
+    // getters
+    bool     IsBuilt()   const {return !sums.empty();}
+    uint32_t GetNBinsX() const {return nCellsX - 2;}
+    uint32_t GetNBinsY() const {return nCellsY - 2;}
+
+  private:
+
+    // cumulative sum up to & incl. cell (ix, iy), 0 if either is -1
+    inline double At(const int64_t ix, const int64_t iy) const {
+      return ((ix < 0) || (iy < 0)) ? 0. : sums[ix + (nCellsX * iy)];
+    }
+
+    // table dimensions & contents
+    uint64_t       nCellsX = 0;
+    uint64_t       nCellsY = 0;
+    vector<double> sums;
+
+};  // end SPrefixSum2D definition
+
+
+
+// SPrefixSum2D implementation ------------------------------------------------
+
+inline void SPrefixSum2D::Build(const double* contents, const uint32_t nBinsX, const uint32_t nBinsY) {
+
+  nCellsX = nBinsX + 2;
+  nCellsY = nBinsY + 2;
+  sums.assign(nCellsX * nCellsY, 0.);
+
+  // running row sum + table entry of row below
+  for (uint64_t iy = 0; iy < nCellsY; iy++) {
+    double sumRow = 0.;
+    for (uint64_t ix = 0; ix < nCellsX; ix++) {
+      const uint64_t iCell = ix + (nCellsX * iy);
+      sumRow     += contents[iCell];
+      sums[iCell] = sumRow + ((iy > 0) ? sums[iCell - nCellsX] : 0.);
+    }
+  }
+  return;
+
+}  // end 'Build(double*, uint32_t, uint32_t)'
+
+
+
+inline void SPrefixSum2D::GetSliceY(const uint32_t ixLo, const uint32_t ixHi, double* slice) const {
+
+  double below = At(ixHi, 0) - At((int64_t) ixLo - 1, 0);
+  for (uint64_t iy = 1; iy <= (nCellsY - 2); iy++) {
+    const double upTo = At(ixHi, iy) - At((int64_t) ixLo - 1, iy);
+    slice[iy - 1] = upTo - below;
+    below         = upTo;
+  }
+  return;
+
+}  // end 'GetSliceY(uint32_t, uint32_t, double*)'
+
+#endif
+
+// end ------------------------------------------------------------------------
@@ -0,0 +1,215 @@
+// ----------------------------------------------------------------------------
+// 'SResolutionFit.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Simultaneous, unbinned fit of the delta-
+// pt/pt resolution as a function of pt.
+// The mean and width are parameterized in
+// pt directly, and a gaussian (plus a flat
+// tail) is fit to every track at once. The
+// likelihood is summed over fixed chunks
+// of tracks in parallel, and the chunks are
+// reduced in order, so the result doesn't
+// depend on the no. of threads.
+// ----------------------------------------------------------------------------
+
+#ifndef SRESOLUTIONFIT_H
+#define SRESOLUTIONFIT_H
+
+// standard c includes
+#include <cmath>
+#include <array>
+#include <vector>
+#include <cstdint>
+// root includes
+#include <Math/Factory.h>
+#include <Math/Functor.h>
+#include <Math/Minimizer.h>
+// user includes
+#include "SFitPool.h"
+
+using namespace std;
+
+
+
+// SResolutionModel definition ------------------------------------------------
+
+// mu(pt)    = p0 + p1 * pt + p2 * pt^2
+// sigma(pt) = sqrt(p3^2 + (p4 * pt)^2)
+// p5        = fraction of tracks in flat tail
+namespace SResolutionModel {
+
+  enum Par {Mu0, Mu1, Mu2, SigConst, SigSlope, FracTail, NPar};
+
+  // formula of mu(pt) + nSig * sigma(pt) for a TF1: parameters
+  // 0-5 line up with the model, & nSig gets its own slot after
+  // them (the tail fraction is carried along but not used)
+  enum BandPar {BandNSig = NPar, NBandPar};
+  const char* const BandFormula = "[0] + [1]*x + [2]*x*x + [6]*sqrt([3]*[3] + [4]*[4]*x*x)";
+  const char* const BandParNames[NBandPar] = {"mu0", "mu1", "mu2", "sigConst", "sigSlope", "fracTail", "nSigma"};
+
+  inline double Mu(const double* par, const double pt) {
+    return par[Mu0] + (par[Mu1] * pt) + (par[Mu2] * pt * pt);
+  }
+
+  inline double Sigma(const double* par, const double pt) {
+    return sqrt((par[SigConst] * par[SigConst]) + (par[SigSlope] * par[SigSlope] * pt * pt));
+  }
+
+}  // end SResolutionModel namespace
+
+
+
+// SResolutionFit definition --------------------------------------------------
+
+class SResolutionFit {
+
+  public:
+
+    // ctor: keeps tracks with pt in [ptLo, ptHi] and
+    // delta-pt/pt in [deltaLo, deltaHi]
+    SResolutionFit(const vector<float>& pt, const vector<float>& deltapt, const double ptLo, const double ptHi, const double deltaLo, const double deltaHi);
+
+    // negative log-likelihood at par
+    double NLL(const double* par, const SFitPool& pool) const;
+
+    // minimize starting from par; par & err hold
+    // the result, returns true if minuit converged
+    bool Fit(array<double, SResolutionModel::NPar>& par, array<double, SResolutionModel::NPar>& err, const SFitPool& pool);
+
+    // getters
+    size_t GetNTracks() const {return ptFit.size();}
+    double GetMinNLL()  const {return nllMin;}
+    size_t GetNCalls()  const {return nCalls;}
+
+  private:
+
+    // tracks per chunk (fixed so the sum is reproducible)
+    static const size_t NChunk = 16384;
+
+    // fit window & selected tracks
+    double        deltaMin = 0.;
+    double        deltaMax = 0.;
+    vector<float> ptFit;
+    vector<float> deltaFit;
+
+    // result
+    double nllMin = 0.;
+    size_t nCalls = 0;
+
+};  // end SResolutionFit definition
+
+
+
+// SResolutionFit implementation ----------------------------------------------
+
+inline SResolutionFit::SResolutionFit(const vector<float>& pt, const vector<float>& deltapt, const double ptLo, const double ptHi, const double deltaLo, const double deltaHi) {
+
+  deltaMin = deltaLo;
+  deltaMax = deltaHi;
+
+  // same arithmetic as the tuple loops
+  for (size_t iTrk = 0; iTrk < pt.size(); iTrk++) {
+    const double ptTrk    = pt[iTrk];
+    const double ptDelta  = deltapt[iTrk] / pt[iTrk];
+    const bool   isInPt   = ((ptTrk >= ptLo) && (ptTrk <= ptHi));
+    const bool   isInDPt  = ((ptDelta >= deltaLo) && (ptDelta <= deltaHi));
+    if (isInPt && isInDPt) {
+      ptFit.push_back(ptTrk);
+      deltaFit.push_back(ptDelta);
+    }
+  }
+
+}  // end ctor(vector<float>&, vector<float>&, double, double, double, double)
+
+
+
+inline double SResolutionFit::NLL(const double* par, const SFitPool& pool) const {
+
+  using namespace SResolutionModel;
+
+  const double fracTail = par[FracTail];
+  const double densTail = fracTail / (deltaMax - deltaMin);
+  const double normPeak = (1. - fracTail) / sqrt(2. * M_PI);
+
+  // sum each chunk into its own slot
+  const size_t   nTrks   = ptFit.size();
+  const size_t   nChunks = (nTrks + NChunk - 1) / NChunk;
+  vector<double> sumChunk(nChunks, 0.);
+  pool.Run(nChunks, [&](const size_t iChunk) {
+    const size_t iStart = iChunk * NChunk;
+    const size_t iStop  = min(iStart + NChunk, nTrks);
+
+    double sum = 0.;
+    for (size_t iTrk = iStart; iTrk < iStop; iTrk++) {
+      const double mu    = Mu(par, ptFit[iTrk]);
+      const double sigma = Sigma(par, ptFit[iTrk]);
+      const double pull  = (deltaFit[iTrk] - mu) / sigma;
+
+      // gaussian is normalized within the fit window
+      const double window = 0.5 * (erf((deltaMax - mu) / (M_SQRT2 * sigma)) - erf((deltaMin - mu) / (M_SQRT2 * sigma)));
+      const double dens   = ((normPeak * exp(-0.5 * pull * pull)) / (sigma * window)) + densTail;
+      sum -= log((dens > 0.) ? dens : 1e-300);
+    }
+    sumChunk[iChunk] = sum;
+  });
+
+  // reduce in chunk order
+  double nll = 0.;
+  for (const double sum : sumChunk) {
+    nll += sum;
+  }
+  return nll;
+
+}  // end 'NLL(double*, SFitPool&)'
+
+
+
+inline bool SResolutionFit::Fit(array<double, SResolutionModel::NPar>& par, array<double, SResolutionModel::NPar>& err, const SFitPool& pool) {
+
+  using namespace SResolutionModel;
+
+  if (ptFit.empty()) return false;
+
+  ROOT::Math::Minimizer* minimizer = ROOT::Math::Factory::CreateMinimizer("Minuit2", "Migrad");
+  if (!minimizer) return false;
+
+  // wrap likelihood
+  nCalls = 0;
+  auto nll = [&](const double* parEval) {
+    ++nCalls;
+    return NLL(parEval, pool);
+  };  // end 'nll(double*)'
+  ROOT::Math::Functor function(nll, NPar);
+
+  // widths are kept positive through the parameterization,
+  // so only the tail fraction needs limits
+  const double width = deltaMax - deltaMin;
+  minimizer -> SetFunction(function);
+  minimizer -> SetErrorDef(0.5);
+  minimizer -> SetPrintLevel(0);
+  minimizer -> SetVariable(Mu0, "mu0", par[Mu0], 0.01 * width);
+  minimizer -> SetVariable(Mu1, "mu1", par[Mu1], 0.001 * width);
+  minimizer -> SetVariable(Mu2, "mu2", par[Mu2], 0.0001 * width);
+  minimizer -> SetVariable(SigConst, "sigConst", par[SigConst], 0.01 * width);
+  minimizer -> SetVariable(SigSlope, "sigSlope", par[SigSlope], 0.001 * width);
+  minimizer -> SetLimitedVariable(FracTail, "fracTail", par[FracTail], 0.01, 0., 0.5);
+
+  const bool isGood = minimizer -> Minimize();
+  for (size_t iPar = 0; iPar < NPar; iPar++) {
+    par[iPar] = minimizer -> X()[iPar];
+    err[iPar] = minimizer -> Errors()[iPar];
+  }
+  par[SigConst] = abs(par[SigConst]);
+  par[SigSlope] = abs(par[SigSlope]);
+  nllMin        = minimizer -> MinValue();
+
+  delete minimizer;
+  return isGood;
+
+}  // end 'Fit(array<double, NPar>&, array<double, NPar>&, SFitPool&)'
+
+#endif
+
+// end ------------------------------------------------------------------------
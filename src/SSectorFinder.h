@@ -0,0 +1,272 @@
+// ----------------------------------------------------------------------------
+// 'SSectorFinder.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Finds the TPC sector boundaries from data:
+// boundaries show up as peaks in the mean of
+// delta-pt/pt vs. phi. Peaks are found with a
+// quick search over the (smoothed) profile,
+// then each one is refined by a gaussian +
+// constant fit, with the fits run at once on
+// an 'SFitPool'. The result is the boundary
+// table used by 'SSectorMask'.
+// ----------------------------------------------------------------------------
+
+#ifndef SSECTORFINDER_H
+#define SSECTORFINDER_H
+
+// standard c includes
+#include <cmath>
+#include <vector>
+#include <utility>
+#include <iostream>
+#include <algorithm>
+#include <functional>
+// root includes
+#include <TH1.h>
+#include <TH2.h>
+#include <TF1.h>
+#include <TString.h>
+#include <TFitResult.h>
+#include <TFitResultPtr.h>
+// user includes
+#include "SFitPool.h"
+#include "SSectorMask.h"
+
+using namespace std;
+
+
+
+// SSectorFinder definition ---------------------------------------------------
+
+class SSectorFinder {
+
+  public:
+
+    // ctor
+    SSectorFinder(const size_t nSec = SSectorMask::NSectors) : nSectors(nSec) {}
+
+    // find boundaries in a map of delta-pt/pt (y) vs. phi (x),
+    // fitting +-fitRange around each peak; boundaries come out
+    // sorted, & a failed fit falls back to its peak position
+    vector<double> Find(const TH2* hDPtVsPhi, const SFitPool& pool, const double fitRange);
+
+    // print table in a form that can be pasted into a macro
+    void PrintTable() const;
+
+    // setters
+    void SetSmoothing(const size_t nBins) {nSmooth = nBins;}
+
+    // getters
+    size_t                GetNFound()     const {return boundaries.size();}
+    TH1D*                 GetProfile()    const {return hProfile;}
+    const vector<TF1*>&   GetFits()       const {return fFits;}
+    const vector<TH1D*>&  GetWindows()    const {return hWindows;}
+    const vector<double>& GetPeaks()      const {return peaks;}
+    const vector<double>& GetBoundaries() const {return boundaries;}
+
+  private:
+
+    // mean delta-pt/pt of each phi column
+    void MakeProfile(const TH2* hDPtVsPhi);
+
+    // highest nSectors local maxima at least half a sector apart
+    void SearchPeaks();
+
+    // parameters
+    size_t nSectors = SSectorMask::NSectors;
+    size_t nSmooth  = 3;
+
+    // profile, & bins of its coarse peaks
+    TH1D*          hProfile = NULL;
+    double         baseline = 0.;
+    vector<size_t> iPeakBins;
+    vector<double> peaks;
+
+    // fit windows & functions, & final boundaries
+    vector<TH1D*>  hWindows;
+    vector<TF1*>   fFits;
+    vector<double> boundaries;
+
+};  // end SSectorFinder definition
+
+
+
+// SSectorFinder implementation -----------------------------------------------
+
+inline vector<double> SSectorFinder::Find(const TH2* hDPtVsPhi, const SFitPool& pool, const double fitRange) {
+
+  MakeProfile(hDPtVsPhi);
+  SearchPeaks();
+
+  const size_t nPeaks = peaks.size();
+  if (nPeaks < nSectors) {
+    cerr << "WARNING: only found " << nPeaks << " of " << nSectors << " sector boundaries!" << endl;
+  }
+
+  // windows are copied out of the profile around each peak, so
+  // they can wrap around +-pi & each fit has its own histogram
+  const size_t nBins = hProfile -> GetNbinsX();
+  const double width = hProfile -> GetBinWidth(1);
+  const size_t nHalf = max((size_t) 1, (size_t) ceil(fitRange / width));
+
+  hWindows.assign(nPeaks, NULL);
+  fFits.assign(nPeaks, NULL);
+  for (size_t iPeak = 0; iPeak < nPeaks; iPeak++) {
+    TString sWindow("hSectorWindow_");
+    TString sFit("fSectorBoundary_");
+    sWindow += iPeak;
+    sFit    += iPeak;
+
+    const double center = hProfile -> GetBinCenter(iPeakBins[iPeak] + 1);
+    const double lo     = center - ((nHalf + 0.5) * width);
+    const double hi     = center + ((nHalf + 0.5) * width);
+    hWindows[iPeak] = new TH1D(sWindow.Data(), "", (2 * nHalf) + 1, lo, hi);
+    hWindows[iPeak] -> SetDirectory(0);
+    for (size_t iWin = 0; iWin < ((2 * nHalf) + 1); iWin++) {
+      const size_t iProf = (iPeakBins[iPeak] + nBins + iWin - nHalf) % nBins;
+      hWindows[iPeak] -> SetBinContent(iWin + 1, hProfile -> GetBinContent(iProf + 1));
+      hWindows[iPeak] -> SetBinError(iWin + 1, hProfile -> GetBinError(iProf + 1));
+    }
+
+    fFits[iPeak] = new TF1(sFit.Data(), "gaus(0) + pol0(3)", lo, hi);
+    fFits[iPeak] -> SetParameter(0, hProfile -> GetBinContent(iPeakBins[iPeak] + 1) - baseline);
+    fFits[iPeak] -> SetParameter(1, center);
+    fFits[iPeak] -> SetParameter(2, 0.5 * fitRange);
+    fFits[iPeak] -> SetParameter(3, baseline);
+    fFits[iPeak] -> SetParLimits(2, width, 2. * fitRange);
+  }
+
+  // fit all windows at once (with Minuit2, which is
+  // safe to share, restoring the default afterwards)
+  const SFitMinimizer minimizer("Minuit2", "Migrad");
+  vector<int>         status(nPeaks, 0);
+  pool.Run(nPeaks, [&](const size_t iPeak) {
+    const TFitResultPtr result = hWindows[iPeak] -> Fit(fFits[iPeak], "RSQ");
+    status[iPeak] = result;
+  });
+
+  // keep fitted means that stay in their window
+  boundaries.clear();
+  for (size_t iPeak = 0; iPeak < nPeaks; iPeak++) {
+    const double mu   = fFits[iPeak] -> GetParameter(1);
+    const bool   isOK = ((status[iPeak] == 0) && (abs(mu - peaks[iPeak]) < fitRange));
+    if (!isOK) {
+      cerr << "WARNING: fit of sector boundary near phi = " << peaks[iPeak] << " failed (status " << status[iPeak] << ")! Using peak position." << endl;
+    }
+    const double phi = isOK ? mu : peaks[iPeak];
+    boundaries.push_back(phi - ((2. * M_PI) * floor((phi + M_PI) / (2. * M_PI))));
+  }
+  sort(boundaries.begin(), boundaries.end());
+  return boundaries;
+
+}  // end 'Find(TH2*, SFitPool&, double)'
+
+
+
+inline void SSectorFinder::PrintTable() const {
+
+  cout << "      Sector boundaries (" << boundaries.size() << "):\n"
+       << "        {";
+  for (size_t iBound = 0; iBound < boundaries.size(); iBound++) {
+    if (iBound > 0) cout << ", ";
+    cout << boundaries[iBound];
+  }
+  cout << "}" << endl;
+  return;
+
+}  // end 'PrintTable()'
+
+
+
+inline void SSectorFinder::MakeProfile(const TH2* hDPtVsPhi) {
+
+  const TAxis* xAxis = hDPtVsPhi -> GetXaxis();
+  const TAxis* yAxis = hDPtVsPhi -> GetYaxis();
+  const size_t nX    = xAxis -> GetNbins();
+  const size_t nY    = yAxis -> GetNbins();
+
+  hProfile = new TH1D("hSectorProfile", "", nX, xAxis -> GetXmin(), xAxis -> GetXmax());
+  hProfile -> SetDirectory(0);
+  for (size_t iX = 1; iX <= nX; iX++) {
+    double sum   = 0.;
+    double sumY  = 0.;
+    double sumY2 = 0.;
+    for (size_t iY = 1; iY <= nY; iY++) {
+      const double content = hDPtVsPhi -> GetBinContent(iX, iY);
+      const double y       = yAxis -> GetBinCenter(iY);
+      sum   += content;
+      sumY  += content * y;
+      sumY2 += content * y * y;
+    }
+    if (sum <= 0.) continue;
+
+    // error on the mean
+    const double mean = sumY / sum;
+    const double var  = max((sumY2 / sum) - (mean * mean), 0.);
+    hProfile -> SetBinContent(iX, mean);
+    hProfile -> SetBinError(iX, sqrt(var / sum));
+  }
+  return;
+
+}  // end 'MakeProfile(TH2*)'
+
+
+
+inline void SSectorFinder::SearchPeaks() {
+
+  // smooth with a circular running mean
+  const size_t   nBins = hProfile -> GetNbinsX();
+  const size_t   nHalf = nSmooth / 2;
+  vector<double> smooth(nBins, 0.);
+  for (size_t iBin = 0; iBin < nBins; iBin++) {
+    for (size_t iOff = 0; iOff <= (2 * nHalf); iOff++) {
+      smooth[iBin] += hProfile -> GetBinContent(((iBin + nBins + iOff - nHalf) % nBins) + 1);
+    }
+    smooth[iBin] /= (2 * nHalf) + 1;
+  }
+
+  // baseline is the median, since boundaries are a small part of phi
+  vector<double> sorted(smooth);
+  nth_element(sorted.begin(), sorted.begin() + (nBins / 2), sorted.end());
+  baseline = sorted[nBins / 2];
+
+  // local maxima above baseline, highest first
+  vector<pair<double, size_t>> candidates;
+  for (size_t iBin = 0; iBin < nBins; iBin++) {
+    const double left  = smooth[(iBin + nBins - 1) % nBins];
+    const double right = smooth[(iBin + 1) % nBins];
+    if ((smooth[iBin] > baseline) && (smooth[iBin] >= left) && (smooth[iBin] > right)) {
+      candidates.push_back(make_pair(smooth[iBin], iBin));
+    }
+  }
+  sort(candidates.begin(), candidates.end(), greater<pair<double, size_t>>());
+
+  // keep highest ones that aren't too close to one already kept
+  const size_t nMinSep = max((size_t) 1, nBins / (2 * nSectors));
+  iPeakBins.clear();
+  peaks.clear();
+  for (const pair<double, size_t>& candidate : candidates) {
+    if (iPeakBins.size() == nSectors) break;
+
+    bool isIsolated = true;
+    for (const size_t iPeakBin : iPeakBins) {
+      const size_t dist = (candidate.second > iPeakBin) ? (candidate.second - iPeakBin) : (iPeakBin - candidate.second);
+      if (min(dist, nBins - dist) < nMinSep) {
+        isIsolated = false;
+        break;
+      }
+    }
+    if (!isIsolated) continue;
+
+    iPeakBins.push_back(candidate.second);
+    peaks.push_back(hProfile -> GetBinCenter(candidate.second + 1));
+  }
+  return;
+
+}  // end 'SearchPeaks()'
+
+#endif
+
+// end ------------------------------------------------------------------------
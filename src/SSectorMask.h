@@ -0,0 +1,155 @@
+// ----------------------------------------------------------------------------
+// 'SSectorMask.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Mask of the TPC sector boundaries in phi.
+// The nearest boundary of every phi bin is
+// looked up once, so the distance of a track
+// to the nearest boundary (& whether it's in
+// the mask) is one array access & a subtraction
+// no matter how many boundaries there are.
+// ----------------------------------------------------------------------------
+
+#ifndef SSECTORMASK_H
+#define SSECTORMASK_H
+
+// standard c includes
+#include <cmath>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+
+using namespace std;
+
+
+
+// SSectorMask definition -----------------------------------------------------
+
+class SSectorMask {
+
+  public:
+
+    // default no. of sectors & of lookup bins in phi
+    static constexpr size_t NSectors = 12;
+    static constexpr size_t NBins    = 4096;
+
+    // ctor
+    SSectorMask() {}
+
+    // set boundaries (in any order, wrapped into [-pi, pi)) & the
+    // full width of the mask around each, and build the lookup
+    void Init(const vector<double>& boundaries, const double width, const size_t nBins = NBins);
+
+    // distance in phi to the nearest boundary
+    inline double GetDistance(const double phi) const;
+
+    // is phi within half the mask width of a boundary?
+    bool IsMasked(const double phi) const {return (GetDistance(phi) < halfWidth);}
+
+    // largest possible distance to the nearest boundary,
+    // i.e. half the widest gap between adjacent boundaries
+    double GetMaxDistance() const;
+
+    // boundaries of nSec equal sectors, with the 1st
+    // centered on phi = 0 (i.e. the sPHENIX tpc)
+    static vector<double> GetDefaultBoundaries(const size_t nSec = NSectors);
+
+    // getters
+    size_t                GetNBoundaries() const {return bounds.size();}
+    double                GetWidth()       const {return 2. * halfWidth;}
+    const vector<double>& GetBoundaries()  const {return bounds;}
+
+  private:
+
+    // mask & lookup parameters
+    double         halfWidth = 0.;
+    double         binScale  = 0.;
+    vector<double> bounds;
+
+    // nearest boundary to the center of each bin, shifted
+    // by 2pi when that's closer so no wrapping is needed
+    vector<double> nearest;
+
+};  // end SSectorMask definition
+
+
+
+// SSectorMask implementation -------------------------------------------------
+
+inline vector<double> SSectorMask::GetDefaultBoundaries(const size_t nSec) {
+
+  const double   sector = (2. * M_PI) / nSec;
+  vector<double> boundaries(nSec);
+  for (size_t iSec = 0; iSec < nSec; iSec++) {
+    boundaries[iSec] = -M_PI + ((iSec + 0.5) * sector);
+  }
+  return boundaries;
+
+}  // end 'GetDefaultBoundaries(size_t)'
+
+
+
+inline void SSectorMask::Init(const vector<double>& boundaries, const double width, const size_t nBins) {
+
+  halfWidth = 0.5 * width;
+  binScale  = nBins / (2. * M_PI);
+
+  bounds.clear();
+  for (const double boundary : boundaries) {
+    bounds.push_back(boundary - ((2. * M_PI) * floor((boundary + M_PI) / (2. * M_PI))));
+  }
+  sort(bounds.begin(), bounds.end());
+
+  // with no boundaries, nothing is masked
+  nearest.assign(nBins, -INFINITY);
+  if (bounds.empty()) return;
+
+  for (size_t iBin = 0; iBin < nBins; iBin++) {
+    const double center = -M_PI + ((iBin + 0.5) / binScale);
+
+    double distMin = INFINITY;
+    for (const double boundary : bounds) {
+      for (const double shift : {-2. * M_PI, 0., 2. * M_PI}) {
+        const double dist = abs(center - (boundary + shift));
+        if (dist < distMin) {
+          distMin       = dist;
+          nearest[iBin] = boundary + shift;
+        }
+      }
+    }
+  }
+  return;
+
+}  // end 'Init(vector<double>&, double, size_t)'
+
+
+
+inline double SSectorMask::GetMaxDistance() const {
+
+  // with no boundaries, every phi is up to pi away
+  if (bounds.empty()) return M_PI;
+
+  // gap across +-pi closes the ring
+  double gapMax = (2. * M_PI) - (bounds.back() - bounds.front());
+  for (size_t iBound = 1; iBound < bounds.size(); iBound++) {
+    gapMax = max(gapMax, bounds[iBound] - bounds[iBound - 1]);
+  }
+  return 0.5 * gapMax;
+
+}  // end 'GetMaxDistance()'
+
+
+
+inline double SSectorMask::GetDistance(const double phi) const {
+
+  // nan or out-of-range phi falls in the edge bins
+  const double pos  = (phi + M_PI) * binScale;
+  const size_t iBin = (pos > 0.) ? (size_t) min(pos, nearest.size() - 1.) : 0;
+  return abs(phi - nearest[iBin]);
+
+}  // end 'GetDistance(double)'
+
+#endif
+
+// end ------------------------------------------------------------------------
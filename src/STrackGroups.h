@@ -0,0 +1,103 @@
+// ----------------------------------------------------------------------------
+// 'STrackGroups.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Groups reco. tracks by the truth particle
+// they came from, i.e. by (event, gtrackID).
+// Groups are found with one hash lookup per
+// track and laid out contiguously (offsets
+// & members), so building & walking them is
+// linear in the no. of tracks no matter how
+// many tracks an event has.
+// ----------------------------------------------------------------------------
+
+#ifndef STRACKGROUPS_H
+#define STRACKGROUPS_H
+
+// standard c includes
+#include <cmath>
+#include <vector>
+#include <cstdint>
+// user includes
+#include "STruthIndex.h"
+
+using namespace std;
+
+
+
+// STrackGroups definition ----------------------------------------------------
+
+class STrackGroups {
+
+  public:
+
+    // ctor
+    STrackGroups() {}
+
+    // group tracks by (event, gtrackID); tracks without
+    // a gtrackID (i.e. no truth particle) aren't grouped
+    void Build(const vector<float>& event, const vector<float>& gtrackID);
+
+    // getters
+    size_t          GetNGroups()                    const {return offsets.empty() ? 0 : offsets.size() - 1;}
+    size_t          GetGroupSize(const size_t iGrp) const {return offsets[iGrp + 1] - offsets[iGrp];}
+    const uint32_t* GetMembers(const size_t iGrp)   const {return &members[offsets[iGrp]];}
+    uint32_t        GetGroup(const size_t iTrk)     const {return groupOf[iTrk];}
+    bool            IsGrouped(const size_t iTrk)    const {return groupOf[iTrk] != STruthIndex::NEmpty;}
+
+  private:
+
+    // group of each track, start of each group, & tracks in group order
+    vector<uint32_t> groupOf;
+    vector<uint32_t> offsets;
+    vector<uint32_t> members;
+
+};  // end STrackGroups definition
+
+
+
+// STrackGroups implementation ------------------------------------------------
+
+inline void STrackGroups::Build(const vector<float>& event, const vector<float>& gtrackID) {
+
+  // number groups in order of 1st appearance
+  const size_t nTrks = event.size();
+  STruthIndex  index;
+  index.Reserve(nTrks);
+  groupOf.assign(nTrks, STruthIndex::NEmpty);
+
+  uint32_t nGroups = 0;
+  for (size_t iTrk = 0; iTrk < nTrks; iTrk++) {
+    if (isnan(gtrackID[iTrk])) continue;
+
+    const uint64_t key    = STruthIndex::MakeKey((uint32_t) event[iTrk], (int32_t) gtrackID[iTrk]);
+    uint32_t       iGroup = index.Find(key);
+    if (iGroup == STruthIndex::NEmpty) {
+      iGroup = nGroups++;
+      index.Insert(key, iGroup);
+    }
+    groupOf[iTrk] = iGroup;
+  }
+
+  // count, then place, members of each group
+  offsets.assign(nGroups + 1, 0);
+  for (size_t iTrk = 0; iTrk < nTrks; iTrk++) {
+    if (groupOf[iTrk] != STruthIndex::NEmpty) ++offsets[groupOf[iTrk] + 1];
+  }
+  for (size_t iGroup = 0; iGroup < nGroups; iGroup++) {
+    offsets[iGroup + 1] += offsets[iGroup];
+  }
+
+  vector<uint32_t> fill(offsets.begin(), offsets.end() - 1);
+  members.assign(offsets.back(), 0);
+  for (size_t iTrk = 0; iTrk < nTrks; iTrk++) {
+    if (groupOf[iTrk] != STruthIndex::NEmpty) members[fill[groupOf[iTrk]]++] = iTrk;
+  }
+  return;
+
+}  // end 'Build(vector<float>&, vector<float>&)'
+
+#endif
+
+// end ------------------------------------------------------------------------
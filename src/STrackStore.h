@@ -0,0 +1,206 @@
+// ----------------------------------------------------------------------------
+// 'STrackStore.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Compact, unbinned record of the good
+// tracks seen by 'SDeltaPtCutStudy', so
+// histograms can be (re)built after the
+// loop without touching the input tuple.
+// ----------------------------------------------------------------------------
+
+#ifndef STRACKSTORE_H
+#define STRACKSTORE_H
+
+// standard c includes
+#include <vector>
+#include <cstdint>
+// root includes
+#include <TTree.h>
+#include <TString.h>
+
+using namespace std;
+
+
+
+// STrackStore definition -----------------------------------------------------
+
+struct STrackStore {
+
+  // stored columns (exact tuple values, so derived
+  // quantities match the tuple loops bit-for-bit)
+  vector<float>    pt;
+  vector<float>    gpt;
+  vector<float>    deltapt;
+  vector<float>    quality;
+  vector<float>    nmvtx;
+  vector<float>    ntpc;
+  vector<float>    event;
+  vector<float>    gtrackID;
+  vector<uint64_t> passCut;
+  vector<uint64_t> passSig;
+
+  // size management
+  size_t GetSize() const {return pt.size();}
+  void   Reserve(const size_t nReserve);
+  void   Clear();
+
+  // add a track & its flat delta-pt cut decisions
+  inline void Add(const float ptTrk, const float gptTrk, const float deltaTrk, const float qualTrk, const float nmvtxTrk, const float ntpcTrk, const float eventTrk, const float idTrk, const uint64_t passCuts) {
+    pt.push_back(ptTrk);
+    gpt.push_back(gptTrk);
+    deltapt.push_back(deltaTrk);
+    quality.push_back(qualTrk);
+    nmvtx.push_back(nmvtxTrk);
+    ntpc.push_back(ntpcTrk);
+    event.push_back(eventTrk);
+    gtrackID.push_back(idTrk);
+    passCut.push_back(passCuts);
+    passSig.push_back(0);
+  }
+
+  // derived quantities (same arithmetic as the tuple loops)
+  inline double GetPtDelta(const size_t iTrk) const {return deltapt[iTrk] / pt[iTrk];}
+  inline double GetPtFrac(const size_t iTrk)  const {return pt[iTrk] / gpt[iTrk];}
+
+  // write store into a tree in the current directory,
+  // or (re)fill store from a tree made by MakeTree()
+  TTree* MakeTree(const TString sName) const;
+  void   ReadTree(TTree* tree);
+
+};  // end STrackStore definition
+
+
+
+// STrackStore implementation -------------------------------------------------
+
+inline void STrackStore::Reserve(const size_t nReserve) {
+
+  pt.reserve(nReserve);
+  gpt.reserve(nReserve);
+  deltapt.reserve(nReserve);
+  quality.reserve(nReserve);
+  nmvtx.reserve(nReserve);
+  ntpc.reserve(nReserve);
+  event.reserve(nReserve);
+  gtrackID.reserve(nReserve);
+  passCut.reserve(nReserve);
+  passSig.reserve(nReserve);
+  return;
+
+}  // end 'Reserve(size_t)'
+
+
+
+inline void STrackStore::Clear() {
+
+  pt.clear();
+  gpt.clear();
+  deltapt.clear();
+  quality.clear();
+  nmvtx.clear();
+  ntpc.clear();
+  event.clear();
+  gtrackID.clear();
+  passCut.clear();
+  passSig.clear();
+  return;
+
+}  // end 'Clear()'
+
+
+
+inline TTree* STrackStore::MakeTree(const TString sName) const {
+
+  // tree addresses
+  float     ptTrk;
+  float     gptTrk;
+  float     deltaTrk;
+  float     qualTrk;
+  float     nmvtxTrk;
+  float     ntpcTrk;
+  float     eventTrk;
+  float     idTrk;
+  float     ptDelta;
+  float     ptFrac;
+  ULong64_t passCuts;
+  ULong64_t passSigs;
+
+  TTree* tree = new TTree(sName.Data(), "good tracks seen by SDeltaPtCutStudy");
+  tree -> Branch("pt",       &ptTrk,    "pt/F");
+  tree -> Branch("gpt",      &gptTrk,   "gpt/F");
+  tree -> Branch("deltapt",  &deltaTrk, "deltapt/F");
+  tree -> Branch("quality",  &qualTrk,  "quality/F");
+  tree -> Branch("nmvtx",    &nmvtxTrk, "nmvtx/F");
+  tree -> Branch("ntpc",     &ntpcTrk,  "ntpc/F");
+  tree -> Branch("event",    &eventTrk, "event/F");
+  tree -> Branch("gtrackID", &idTrk,    "gtrackID/F");
+  tree -> Branch("ptDelta",  &ptDelta,  "ptDelta/F");
+  tree -> Branch("ptFrac",   &ptFrac,   "ptFrac/F");
+  tree -> Branch("passCut",  &passCuts, "passCut/l");
+  tree -> Branch("passSig",  &passSigs, "passSig/l");
+
+  for (size_t iTrk = 0; iTrk < GetSize(); iTrk++) {
+    ptTrk    = pt[iTrk];
+    gptTrk   = gpt[iTrk];
+    deltaTrk = deltapt[iTrk];
+    qualTrk  = quality[iTrk];
+    nmvtxTrk = nmvtx[iTrk];
+    ntpcTrk  = ntpc[iTrk];
+    eventTrk = event[iTrk];
+    idTrk    = gtrackID[iTrk];
+    ptDelta  = GetPtDelta(iTrk);
+    ptFrac   = GetPtFrac(iTrk);
+    passCuts = passCut[iTrk];
+    passSigs = passSig[iTrk];
+    tree -> Fill();
+  }
+
+  // addresses point at locals, so don't leave them behind
+  tree -> ResetBranchAddresses();
+  return tree;
+
+}  // end 'MakeTree(TString)'
+
+
+
+inline void STrackStore::ReadTree(TTree* tree) {
+
+  // tree addresses
+  float     ptTrk;
+  float     gptTrk;
+  float     deltaTrk;
+  float     qualTrk;
+  float     nmvtxTrk;
+  float     ntpcTrk;
+  float     eventTrk;
+  float     idTrk;
+  ULong64_t passCuts;
+  ULong64_t passSigs;
+
+  tree -> SetBranchAddress("pt",       &ptTrk);
+  tree -> SetBranchAddress("gpt",      &gptTrk);
+  tree -> SetBranchAddress("deltapt",  &deltaTrk);
+  tree -> SetBranchAddress("quality",  &qualTrk);
+  tree -> SetBranchAddress("nmvtx",    &nmvtxTrk);
+  tree -> SetBranchAddress("ntpc",     &ntpcTrk);
+  tree -> SetBranchAddress("event",    &eventTrk);
+  tree -> SetBranchAddress("gtrackID", &idTrk);
+  tree -> SetBranchAddress("passCut",  &passCuts);
+  tree -> SetBranchAddress("passSig",  &passSigs);
+
+  Clear();
+  Reserve(tree -> GetEntries());
+  for (int64_t iTrk = 0; iTrk < tree -> GetEntries(); iTrk++) {
+    tree -> GetEntry(iTrk);
+    Add(ptTrk, gptTrk, deltaTrk, qualTrk, nmvtxTrk, ntpcTrk, eventTrk, idTrk, passCuts);
+    passSig.back() = passSigs;
+  }
+  tree -> ResetBranchAddresses();
+  return;
+
+}  // end 'ReadTree(TTree*)'
+
+#endif
+
+// end ------------------------------------------------------------------------
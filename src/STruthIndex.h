@@ -0,0 +1,152 @@
+// ----------------------------------------------------------------------------
+// 'STruthIndex.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Index of truth particles keyed by their
+// (event, gtrackID), so a reco. track can be
+// joined to its truth particle in O(1). It's
+// an open-addressing hash map with linear
+// probing over flat key & value arrays,
+// kept at most half full.
+// ----------------------------------------------------------------------------
+
+#ifndef STRUTHINDEX_H
+#define STRUTHINDEX_H
+
+// standard c includes
+#include <vector>
+#include <cstdint>
+
+using namespace std;
+
+
+
+// STruthIndex definition -----------------------------------------------------
+
+class STruthIndex {
+
+  public:
+
+    // value of an empty slot & of a failed lookup
+    static constexpr uint32_t NEmpty = 0xffffffff;
+
+    // ctor
+    STruthIndex() {}
+
+    // pack an (event, gtrackID) pair into a key
+    static uint64_t MakeKey(const uint32_t event, const int32_t id) {return ((uint64_t) event << 32) | (uint32_t) id;}
+
+    // clear & size table for nEntries keys
+    void Reserve(const size_t nEntries);
+
+    // add a key, returns false (& keeps the 1st
+    // value) if the key is already there
+    bool Insert(const uint64_t key, const uint32_t value);
+
+    // value of a key, or NEmpty if it's not there
+    inline uint32_t Find(const uint64_t key) const;
+
+    // getters
+    size_t GetSize()     const {return nKeys;}
+    size_t GetCapacity() const {return keys.size();}
+
+  private:
+
+    // mix key bits (murmur3 finalizer)
+    static uint64_t Mix(uint64_t key);
+
+    // double table size & reinsert keys
+    void Grow();
+
+    // table (size is a power of 2)
+    size_t           nKeys = 0;
+    uint64_t         mask  = 0;
+    vector<uint64_t> keys;
+    vector<uint32_t> values;
+
+};  // end STruthIndex definition
+
+
+
+// STruthIndex implementation -------------------------------------------------
+
+inline uint64_t STruthIndex::Mix(uint64_t key) {
+
+  key ^= key >> 33;
+  key *= 0xff51afd7ed558ccdULL;
+  key ^= key >> 33;
+  key *= 0xc4ceb9fe1a85ec53ULL;
+  key ^= key >> 33;
+  return key;
+
+}  // end 'Mix(uint64_t)'
+
+
+
+inline void STruthIndex::Reserve(const size_t nEntries) {
+
+  size_t nSlots = 16;
+  while (nSlots < (2 * nEntries)) {
+    nSlots <<= 1;
+  }
+  nKeys = 0;
+  mask  = nSlots - 1;
+  keys.assign(nSlots, 0);
+  values.assign(nSlots, NEmpty);
+  return;
+
+}  // end 'Reserve(size_t)'
+
+
+
+inline bool STruthIndex::Insert(const uint64_t key, const uint32_t value) {
+
+  if (keys.empty() || (2 * (nKeys + 1) > keys.size())) Grow();
+
+  for (uint64_t iSlot = Mix(key) & mask;; iSlot = (iSlot + 1) & mask) {
+    if (values[iSlot] == NEmpty) {
+      keys[iSlot]   = key;
+      values[iSlot] = value;
+      ++nKeys;
+      return true;
+    }
+    if (keys[iSlot] == key) return false;
+  }
+
+}  // end 'Insert(uint64_t, uint32_t)'
+
+
+
+inline uint32_t STruthIndex::Find(const uint64_t key) const {
+
+  if (keys.empty()) return NEmpty;
+
+  for (uint64_t iSlot = Mix(key) & mask;; iSlot = (iSlot + 1) & mask) {
+    if (values[iSlot] == NEmpty) return NEmpty;
+    if (keys[iSlot] == key)      return values[iSlot];
+  }
+
+}  // end 'Find(uint64_t)'
+
+
+
+inline void STruthIndex::Grow() {
+
+  const size_t     nOld = keys.size();
+  vector<uint64_t> oldKeys;
+  vector<uint32_t> oldValues;
+  oldKeys.swap(keys);
+  oldValues.swap(values);
+
+  Reserve((nOld == 0) ? 8 : nOld);
+  for (size_t iSlot = 0; iSlot < oldKeys.size(); iSlot++) {
+    if (oldValues[iSlot] != NEmpty) Insert(oldKeys[iSlot], oldValues[iSlot]);
+  }
+  return;
+
+}  // end 'Grow()'
+
+#endif
+
+// end ------------------------------------------------------------------------
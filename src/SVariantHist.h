@@ -0,0 +1,391 @@
+// ----------------------------------------------------------------------------
+// 'SVariantHist.h'
+// Derek Anderson
+// 10.18.2026
+//
+// Contiguous fill engine for the cut-
+// dependent histograms of 'SDeltaPtCutStudy'.
+// All cut variants of one observable live
+// in a single array with the cut index as
+// the innermost dimension, and are exported
+// to ordinary ROOT histograms at the end.
+// 'SFillBuffer' batches tracks so that bins
+// are found column-by-column with a SIMD
+// kernel and scattered into the engines in
+// one sweep, optionally on an 'SFitPool'
+// where each thread owns whole engines, so
+// no engine is ever copied or written twice.
+// ----------------------------------------------------------------------------
+
+#ifndef SVARIANTHIST_H
+#define SVARIANTHIST_H
+
+// standard c includes
+#include <cmath>
+#include <vector>
+#include <cassert>
+#include <utility>
+#include <cstdint>
+#include <iostream>
+// root includes
+#include <TH1.h>
+// user includes
+#include "SFitPool.h"
+
+using namespace std;
+
+// vector types for the bin-index kernel
+typedef double  SVec4D __attribute__((vector_size(32)));
+typedef int32_t SVec4I __attribute__((vector_size(16)));
+
+
+
+// SVariantAxis definition ----------------------------------------------------
+
+struct SVariantAxis {
+
+  uint32_t nBins = 1;
+  double   xMin  = 0.;
+  double   xMax  = 1.;
+
+  SVariantAxis() {}
+  SVariantAxis(const uint32_t n, const double lo, const double hi) : nBins(n), xMin(lo), xMax(hi) {}
+
+  // same convention as TAxis::FindFixBin for uniform bins:
+  //   0 = underflow, nBins + 1 = overflow
+  inline uint32_t FindBin(const double x) const {
+    if (x < xMin)    return 0;
+    if (!(x < xMax)) return nBins + 1;
+    return 1 + (uint32_t) (nBins * (x - xMin) / (xMax - xMin));
+  }
+
+  // block version, 4 lanes at a time: same arithmetic as
+  // FindBin() in every lane, so bins are identical to it
+  inline void FindBins(const double* x, uint32_t* bins, const size_t n) const {
+
+    const double width = xMax - xMin;
+    const double count = nBins;
+    const SVec4D vMin   = {xMin,  xMin,  xMin,  xMin};
+    const SVec4D vMax   = {xMax,  xMax,  xMax,  xMax};
+    const SVec4D vWidth = {width, width, width, width};
+    const SVec4D vCount = {count, count, count, count};
+    const SVec4D vZero  = {0.,    0.,    0.,    0.};
+    const SVec4I vUnder = {0, 0, 0, 0};
+    const SVec4I vOver  = {(int32_t) nBins + 1, (int32_t) nBins + 1, (int32_t) nBins + 1, (int32_t) nBins + 1};
+
+    // vectorized body: out-of-range lanes (& NaN, which ends
+    // up in overflow like TAxis) are zeroed before converting
+    size_t i = 0;
+    for (; (i + 4) <= n; i += 4) {
+      SVec4D value;
+      __builtin_memcpy(&value, x + i, sizeof(value));
+      const auto   under   = (value < vMin);
+      const auto   over    = !(value < vMax);
+      const SVec4I isUnder = __builtin_convertvector(under, SVec4I);
+      const SVec4I isOver  = __builtin_convertvector(over, SVec4I);
+      SVec4D       inner   = (vCount * (value - vMin)) / vWidth;
+      inner = ((under | over) != 0) ? vZero : inner;
+
+      SVec4I bin = __builtin_convertvector(inner, SVec4I) + 1;
+      bin = (isUnder != 0) ? vUnder : bin;
+      bin = (isOver != 0)  ? vOver  : bin;
+      __builtin_memcpy(bins + i, &bin, sizeof(bin));
+    }
+
+    // remainder
+    for (; i < n; i++) {
+      bins[i] = FindBin(x[i]);
+    }
+    return;
+  }
+
+};  // end SVariantAxis definition
+
+
+
+// SVariantHist definition ----------------------------------------------------
+
+class SVariantHist {
+
+  public:
+
+    // ctors
+    SVariantHist() {}
+    SVariantHist(const size_t nVariant, const SVariantAxis& xAxis);
+    SVariantHist(const size_t nVariant, const SVariantAxis& xAxis, const SVariantAxis& yAxis);
+
+    // bin lookup (same global bin numbering as TH1::GetBin)
+    inline uint64_t FindBin(const double x) const;
+    inline uint64_t FindBin(const double x, const double y) const;
+    inline uint64_t GetBin(const uint32_t iBinX, const uint32_t iBinY = 0) const {
+      return iBinX + (nCellsX * iBinY);
+    }
+
+    // fill a variant with a precomputed global bin
+    inline void Fill(const size_t iVar, const uint64_t iBin) {
+      ++counts[(iBin * nVar) + iVar];
+    }
+
+    // export/import a variant to/from a ROOT histogram with identical binning
+    void Export(const size_t iVar, TH1* hist) const;
+    void Import(const size_t iVar, const TH1* hist);
+    void Add(const SVariantHist& other);
+    void Reset();
+
+    // getters
+    size_t       GetNVariants() const {return nVar;}
+    uint64_t     GetNCells()    const {return nCells;}
+    SVariantAxis GetXAxis()     const {return axisX;}
+    SVariantAxis GetYAxis()     const {return axisY;}
+
+  private:
+
+    // binning
+    size_t       nVar    = 0;
+    uint64_t     nCellsX = 0;
+    uint64_t     nCells  = 0;
+    SVariantAxis axisX;
+    SVariantAxis axisY;
+
+    // bin contents, laid out as [global bin][variant]
+    vector<double> counts;
+
+};  // end SVariantHist definition
+
+
+
+// SVariantHist implementation ------------------------------------------------
+
+inline SVariantHist::SVariantHist(const size_t nVariant, const SVariantAxis& xAxis) {
+
+  nVar    = nVariant;
+  axisX   = xAxis;
+  nCellsX = axisX.nBins + 2;
+  nCells  = nCellsX;
+  counts.assign(nCells * nVar, 0.);
+
+}  // end ctor(size_t, SVariantAxis)
+
+
+
+inline SVariantHist::SVariantHist(const size_t nVariant, const SVariantAxis& xAxis, const SVariantAxis& yAxis) {
+
+  nVar    = nVariant;
+  axisX   = xAxis;
+  axisY   = yAxis;
+  nCellsX = axisX.nBins + 2;
+  nCells  = nCellsX * (axisY.nBins + 2);
+  counts.assign(nCells * nVar, 0.);
+
+}  // end ctor(size_t, SVariantAxis, SVariantAxis)
+
+
+
+inline uint64_t SVariantHist::FindBin(const double x) const {
+
+  return axisX.FindBin(x);
+
+}  // end 'FindBin(double)'
+
+
+
+inline uint64_t SVariantHist::FindBin(const double x, const double y) const {
+
+  return GetBin(axisX.FindBin(x), axisY.FindBin(y));
+
+}  // end 'FindBin(double, double)'
+
+
+
+inline void SVariantHist::Export(const size_t iVar, TH1* hist) const {
+
+  // make sure binning matches
+  if (!hist || ((uint64_t) hist -> GetNcells() != nCells)) {
+    cerr << "PANIC: trying to export variant histogram into a histogram with different binning!\n"
+         << "       hist = " << hist << ", nCells = " << nCells
+         << endl;
+    assert(hist && ((uint64_t) hist -> GetNcells() == nCells));
+  }
+
+  // copy contents (fills are unweighted, so sumw2 = sumw)
+  double nEntries = 0.;
+  for (uint64_t iBin = 0; iBin < nCells; iBin++) {
+    const double content = counts[(iBin * nVar) + iVar];
+    hist -> SetBinContent(iBin, content);
+    hist -> SetBinError(iBin, sqrt(content));
+    nEntries += content;
+  }
+
+  // recompute stats from bin contents
+  hist -> ResetStats();
+  hist -> SetEntries(nEntries);
+  return;
+
+}  // end 'Export(size_t, TH1*)'
+
+
+
+inline void SVariantHist::Import(const size_t iVar, const TH1* hist) {
+
+  // make sure binning matches
+  if (!hist || ((uint64_t) hist -> GetNcells() != nCells)) {
+    cerr << "PANIC: trying to import variant histogram from a histogram with different binning!\n"
+         << "       hist = " << hist << ", nCells = " << nCells
+         << endl;
+    assert(hist && ((uint64_t) hist -> GetNcells() == nCells));
+  }
+
+  // copy contents
+  for (uint64_t iBin = 0; iBin < nCells; iBin++) {
+    counts[(iBin * nVar) + iVar] = hist -> GetBinContent(iBin);
+  }
+  return;
+
+}  // end 'Import(size_t, TH1*)'
+
+
+
+inline void SVariantHist::Add(const SVariantHist& other) {
+
+  assert(other.counts.size() == counts.size());
+  for (size_t iCount = 0; iCount < counts.size(); iCount++) {
+    counts[iCount] += other.counts[iCount];
+  }
+  return;
+
+}  // end 'Add(SVariantHist&)'
+
+
+
+inline void SVariantHist::Reset() {
+
+  counts.assign(nCells * nVar, 0.);
+  return;
+
+}  // end 'Reset()'
+
+
+
+// SFillBuffer definition -----------------------------------------------------
+
+class SFillBuffer {
+
+  public:
+
+    // ctors (one buffer per loop/thread, never shared)
+    SFillBuffer() {}
+    SFillBuffer(const vector<SVariantAxis>& colAxes, const size_t size);
+
+    // add a track: one value per column, and a mask of variants to fill
+    inline void Add(const double* colValues, const uint64_t passMask) {
+      for (size_t iCol = 0; iCol < nCol; iCol++) {
+        values[iCol][nFill] = colValues[iCol];
+      }
+      pass[nFill] = passMask;
+      ++nFill;
+    }
+
+    // find bins for all buffered tracks and scatter into engines, where
+    // histCols[iHist] = (x column, y column or -1) of engines[iHist];
+    // with a pool, columns & engines are spread over its threads
+    void Flush(vector<SVariantHist>& engines, const vector<pair<int, int>>& histCols);
+    void Flush(vector<SVariantHist>& engines, const vector<pair<int, int>>& histCols, const SFitPool& pool);
+
+    // getters
+    bool   IsFull()   const {return (nFill >= nSize);}
+    size_t GetNFill() const {return nFill;}
+
+  private:
+
+    // scatter all buffered tracks into one engine
+    void Scatter(SVariantHist& engine, const pair<int, int>& cols) const;
+
+    // buffer sizes
+    size_t nCol  = 0;
+    size_t nSize = 0;
+    size_t nFill = 0;
+
+    // buffered columns, pass masks, & scratch bins
+    vector<SVariantAxis>     axes;
+    vector<vector<double>>   values;
+    vector<vector<uint32_t>> bins;
+    vector<uint64_t>         pass;
+
+};  // end SFillBuffer definition
+
+
+
+// SFillBuffer implementation -------------------------------------------------
+
+inline SFillBuffer::SFillBuffer(const vector<SVariantAxis>& colAxes, const size_t size) {
+
+  nCol  = colAxes.size();
+  nSize = (size > 0) ? size : 1;
+  nFill = 0;
+  axes  = colAxes;
+  values.assign(nCol, vector<double>(nSize, 0.));
+  bins.assign(nCol, vector<uint32_t>(nSize, 0));
+  pass.assign(nSize, 0);
+
+}  // end ctor(vector<SVariantAxis>, size_t)
+
+
+
+inline void SFillBuffer::Flush(vector<SVariantHist>& engines, const vector<pair<int, int>>& histCols) {
+
+  // nothing to do if buffer is empty
+  if (nFill == 0) return;
+
+  // find bins column by column, then scatter engine by engine
+  for (size_t iCol = 0; iCol < nCol; iCol++) {
+    axes[iCol].FindBins(values[iCol].data(), bins[iCol].data(), nFill);
+  }
+  for (size_t iHist = 0; iHist < engines.size(); iHist++) {
+    Scatter(engines[iHist], histCols[iHist]);
+  }
+  nFill = 0;
+  return;
+
+}  // end 'Flush(vector<SVariantHist>&, vector<pair<int, int>>&)'
+
+
+
+inline void SFillBuffer::Flush(vector<SVariantHist>& engines, const vector<pair<int, int>>& histCols, const SFitPool& pool) {
+
+  // nothing to do if buffer is empty
+  if (nFill == 0) return;
+
+  // find bins column by column
+  pool.Run(nCol, [&](const size_t iCol) {
+    axes[iCol].FindBins(values[iCol].data(), bins[iCol].data(), nFill);
+  });
+
+  // each engine is only touched by the thread that
+  // runs its job, so threads never share a bin
+  pool.Run(engines.size(), [&](const size_t iHist) {
+    Scatter(engines[iHist], histCols[iHist]);
+  });
+  nFill = 0;
+  return;
+
+}  // end 'Flush(vector<SVariantHist>&, vector<pair<int, int>>&, SFitPool&)'
+
+
+
+inline void SFillBuffer::Scatter(SVariantHist& engine, const pair<int, int>& cols) const {
+
+  const uint32_t* binX = bins[cols.first].data();
+  const uint32_t* binY = (cols.second < 0) ? NULL : bins[cols.second].data();
+  for (size_t iFill = 0; iFill < nFill; iFill++) {
+    const uint64_t iBin = binY ? engine.GetBin(binX[iFill], binY[iFill]) : binX[iFill];
+    for (uint64_t mask = pass[iFill]; mask != 0; mask &= (mask - 1)) {
+      engine.Fill(__builtin_ctzll(mask), iBin);
+    }
+  }
+  return;
+
+}  // end 'Scatter(SVariantHist&, pair<int, int>&)'
+
+#endif
+
+// end ------------------------------------------------------------------------